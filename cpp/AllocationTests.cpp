@@ -0,0 +1,168 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Checks that hot loops in the library don't allocate. This is its own program, rather than part of main.cpp, because it
+// replaces the global allocation functions to count calls, and that must not leak into the library.
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <math.h>
+#include <new>
+#include <stdlib.h>
+#include <vector>
+
+#include "DBSCAN.h"
+#include "Parallel.h"
+#include "SparseMatrix.h"
+#include "Vector.h"
+
+/// Counts heap allocations made anywhere in the process, the library included.
+static std::atomic<size_t> g_allocations(0);
+
+// Kept out of line: GCC otherwise sees malloc() and free() inlined into new and delete expressions, and warns that
+// they are mismatched.
+#if defined(__GNUC__)
+#define NOT_INLINED __attribute__((noinline))
+#else
+#define NOT_INLINED
+#endif
+
+NOT_INLINED void* operator new(size_t size)
+{
+	++g_allocations;
+	void* p = malloc(size ? size : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+
+NOT_INLINED void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+NOT_INLINED void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+/// The 2D Poisson stencil on a grid, skewed along one axis so that it isn't symmetric.
+LibMath::SparseMatrix poisson(size_t grid, double skew)
+{
+	std::vector<size_t> rows;
+	std::vector<size_t> cols;
+	std::vector<double> values;
+	for (size_t a = 0; a < grid; ++a)
+	{
+		for (size_t b = 0; b < grid; ++b)
+		{
+			size_t i = a * grid + b;
+			rows.push_back(i); cols.push_back(i); values.push_back(4.0);
+			if (a > 0) { rows.push_back(i); cols.push_back(i - grid); values.push_back(-1.0); }
+			if (a + 1 < grid) { rows.push_back(i); cols.push_back(i + grid); values.push_back(-1.0); }
+			if (b > 0) { rows.push_back(i); cols.push_back(i - 1); values.push_back(-1.0 - skew); }
+			if (b + 1 < grid) { rows.push_back(i); cols.push_back(i + 1); values.push_back(-1.0 + skew); }
+		}
+	}
+	return LibMath::SparseMatrix(grid * grid, grid * grid, rows.data(), cols.data(), values.data(), values.size());
+}
+
+/// The solvers allocate per solve, never per iteration: 2 and 40 iterations must allocate the same amount, on one
+/// thread and with the products split (the grid is big enough for more than one part per product).
+bool sparseSolverTests()
+{
+	std::cout << "Sparse Solver Allocation Tests:" << std::endl;
+	std::cout << "-------------------------------" << std::endl;
+
+	const size_t grid = 230;
+	LibMath::SparseMatrix A = poisson(grid, 0.1);
+	LibMath::Vector rhs(grid * grid);
+	LibMath::Vector solution(grid * grid);
+	std::fill(rhs.m_data, rhs.m_data + rhs.size(), 1.0);
+
+	bool passed = true;
+	for (size_t numThreads = 1; numThreads <= 4; numThreads += 3)
+	{
+		LibMath::Parallel::setNumThreads(numThreads);
+		for (int solver = 0; solver < 2; ++solver)
+		{
+			auto allocationsFor = [&](size_t maxIterations) {
+				std::fill(solution.m_data, solution.m_data + solution.size(), 0.0);
+				size_t before = g_allocations.load();
+				size_t iterations = 0;
+				if (solver == 0)
+					LibMath::IterativeSolvers::conjugateGradient(&A, &rhs, &solution, 0.0, maxIterations, true, &iterations);
+				else
+					LibMath::IterativeSolvers::biCGSTAB(&A, &rhs, &solution, 0.0, maxIterations, false, &iterations);
+				size_t allocations = g_allocations.load() - before;
+				return (iterations == maxIterations) ? allocations : (size_t)-1;
+			};
+			allocationsFor(1);
+			size_t shortRun = allocationsFor(2);
+			size_t longRun = allocationsFor(40);
+			std::cout << ((solver == 0) ? "CG" : "BiCGSTAB") << " on " << numThreads << " thread(s), allocations for 2 and 40 iterations: "
+				<< shortRun << " " << longRun << std::endl;
+			passed = passed && (shortRun != (size_t)-1) && (shortRun == longRun);
+		}
+	}
+	LibMath::Parallel::setNumThreads(0);
+	std::cout << std::endl;
+	return passed;
+}
+
+/// DBSCAN's neighborhood queries use per-thread scratch space, so ten times the points over the same grid cells must
+/// not take more allocations.
+bool dbscanTests()
+{
+	std::cout << "DBSCAN Allocation Tests:" << std::endl;
+	std::cout << "------------------------" << std::endl;
+
+	const size_t MAX_POINTS = 20000;
+	std::vector<double> points(2 * MAX_POINTS);
+	std::vector<size_t> tags(MAX_POINTS);
+	for (size_t i = 0; i < MAX_POINTS; ++i)
+	{
+		points[2 * i] = 0.5 + 0.4 * sin((double)i);
+		points[2 * i + 1] = 0.5 + 0.4 * cos(1.7 * (double)i);
+	}
+
+	LibMath::Parallel::setNumThreads(1);
+	auto allocationsFor = [&](size_t numPoints) {
+		size_t before = g_allocations.load();
+		LibMath::DBSCAN::dbscan(points.data(), numPoints, 2, 1.0, 4, tags.data());
+		return g_allocations.load() - before;
+	};
+	size_t fewPoints = allocationsFor(MAX_POINTS / 10);
+	size_t manyPoints = allocationsFor(MAX_POINTS);
+	LibMath::Parallel::setNumThreads(0);
+	std::cout << "Allocations for " << MAX_POINTS / 10 << " and " << MAX_POINTS << " points: " << fewPoints << " " << manyPoints << std::endl;
+	std::cout << std::endl;
+	return manyPoints <= fewPoints;
+}
+
+int main(void)
+{
+	bool passed = sparseSolverTests();
+	passed = dbscanTests() && passed;
+	std::cout << (passed ? "Passed." : "FAILED.") << std::endl;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,395 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BKTree.h"
+#include "Distance.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace LibMath
+{
+	namespace
+	{
+	const uint64_t MAGIC = 0x31454552544b4221ULL; // "!BKTREE1"
+	const size_t   HEADER_WORDS = 4;               // magic, number of entries, number of nodes, text length
+	const size_t   NODE_WORDS = 5;
+
+	// Fields of a node.
+	const size_t   FIRST_ENTRY = 0;
+	const size_t   NUM_ENTRIES = 1;
+	const size_t   FIRST_CHILD = 2;
+	const size_t   NUM_CHILDREN = 3;
+	const size_t   EDGE = 4;
+
+	inline size_t roundUp8(size_t numBytes)
+	{
+		return (numBytes + 7) & ~(size_t)7;
+	}
+
+	/// Bytes needed for a tree with the given number of entries, nodes and text bytes.
+	inline size_t bufferSize(size_t numStrings, size_t numNodes, size_t poolLen)
+	{
+		return (HEADER_WORDS + numStrings + 1) * sizeof(uint64_t) +
+			roundUp8(numNodes * NODE_WORDS * sizeof(uint32_t)) +
+			roundUp8(numStrings * sizeof(uint32_t)) +
+			roundUp8(poolLen);
+	}
+
+	/// A node whose entries haven't been split up yet, covering order[begin, end).
+	struct PendingNode
+	{
+		size_t node;
+		size_t begin;
+		size_t end;
+	};
+
+	/// A run of entries at the same distance from their parent's string, covering order[begin, end).
+	struct ChildGroup
+	{
+		uint32_t distance;
+		size_t   begin;
+		size_t   end;
+	};
+	}
+
+	BKTree::BKTree() :
+		m_buffer(NULL),
+		m_bufferLen(0),
+		m_numStrings(0),
+		m_numNodes(0),
+		m_offsets(NULL),
+		m_nodes(NULL),
+		m_order(NULL),
+		m_pool(NULL)
+	{
+	}
+
+	BKTree::~BKTree(void)
+	{
+	}
+
+	void BKTree::clear(void)
+	{
+		m_storage.clear();
+		m_buffer = NULL;
+		m_bufferLen = 0;
+		m_numStrings = 0;
+		m_numNodes = 0;
+		m_offsets = NULL;
+		m_nodes = NULL;
+		m_order = NULL;
+		m_pool = NULL;
+	}
+
+	bool BKTree::setPointers(const uint8_t* buffer, size_t bufferLen)
+	{
+		const uint64_t* header = (const uint64_t*)buffer;
+		size_t numStrings = (size_t)header[1];
+		size_t numNodes = (size_t)header[2];
+		size_t poolLen = (size_t)header[3];
+
+		if ((header[0] != MAGIC) || (numStrings > bufferLen / 12) || (numNodes > numStrings) || (poolLen > bufferLen) ||
+			(bufferSize(numStrings, numNodes, poolLen) > bufferLen))
+		{
+			return false;
+		}
+
+		m_buffer = buffer;
+		m_bufferLen = bufferSize(numStrings, numNodes, poolLen);
+		m_numStrings = numStrings;
+		m_numNodes = numNodes;
+		m_offsets = header + HEADER_WORDS;
+		m_nodes = (const uint32_t*)(m_offsets + numStrings + 1);
+		m_order = m_nodes + roundUp8(numNodes * NODE_WORDS * sizeof(uint32_t)) / sizeof(uint32_t);
+		m_pool = (const char*)(m_order + roundUp8(numStrings * sizeof(uint32_t)) / sizeof(uint32_t));
+		return true;
+	}
+
+	bool BKTree::isConsistent(void) const
+	{
+		size_t poolLen = (size_t)((const uint64_t*)m_buffer)[3];
+
+		// Every entry's text lies inside the pool.
+		for (size_t i = 0; i < m_numStrings; ++i)
+		{
+			if (m_offsets[i] > m_offsets[i + 1])
+				return false;
+		}
+		if (m_offsets[m_numStrings] > poolLen)
+			return false;
+
+		// Every node has at least its own string, and its entries and children are in range. Children come after their
+		// parent, so a query can't loop.
+		for (size_t i = 0; i < m_numNodes; ++i)
+		{
+			const uint32_t* node = m_nodes + i * NODE_WORDS;
+			if ((node[NUM_ENTRIES] == 0) || ((size_t)node[FIRST_ENTRY] + node[NUM_ENTRIES] > m_numStrings))
+				return false;
+			if ((size_t)node[FIRST_CHILD] + node[NUM_CHILDREN] > m_numNodes)
+				return false;
+			if ((node[NUM_CHILDREN] > 0) && (node[FIRST_CHILD] <= i))
+				return false;
+		}
+
+		for (size_t i = 0; i < m_numStrings; ++i)
+		{
+			if (m_order[i] >= m_numStrings)
+				return false;
+		}
+		return true;
+	}
+
+	bool BKTree::build(const char* const* strings, size_t numStrings)
+	{
+		const size_t MIN_DISTANCES_PER_THREAD = 2048;
+
+		clear();
+
+		// Sanity check.
+		if ((strings == NULL) || (numStrings >= (size_t)UINT32_MAX))
+		{
+			return false;
+		}
+
+		// Gather the text into one block.
+		std::vector<uint64_t> offsets(numStrings + 1);
+		std::vector<char> pool;
+		for (size_t i = 0; i < numStrings; ++i)
+		{
+			offsets[i] = pool.size();
+			if (strings[i] == NULL)
+				return false;
+			pool.insert(pool.end(), strings[i], strings[i] + strlen(strings[i]));
+		}
+		offsets[numStrings] = pool.size();
+
+		std::vector<uint32_t> order(numStrings);
+		for (size_t i = 0; i < numStrings; ++i)
+			order[i] = (uint32_t)i;
+
+		// Split the tree one level at a time. The first entry of each node's range is its string; the rest are sorted by
+		// their distance to it, so that duplicates of it come first and each run of equal distances becomes a child.
+		std::vector<uint32_t> nodes;
+		std::vector<PendingNode> level;
+		std::vector<PendingNode> nextLevel;
+		std::vector<std::vector<ChildGroup> > groups;
+		if (numStrings > 0)
+		{
+			nodes.assign(NODE_WORDS, 0);
+			PendingNode root = { 0, 0, numStrings };
+			level.push_back(root);
+		}
+		while (!level.empty())
+		{
+			// Spread one loop across the threads, not both: the nodes once there are enough to go around, and each
+			// node's distances before then, while the level is still narrow.
+			bool wide = level.size() >= Parallel::numThreads();
+			groups.assign(level.size(), std::vector<ChildGroup>());
+			Parallel::forRange(level.size(), wide ? 1 : level.size(), [&](size_t first, size_t last) {
+				std::vector<std::pair<uint32_t, uint32_t> > byDistance;
+				for (size_t levelIndex = first; levelIndex < last; ++levelIndex)
+				{
+					const PendingNode& pending = level[levelIndex];
+					uint32_t pivot = order[pending.begin];
+					const char* pivotStr = pool.data() + offsets[pivot];
+					size_t pivotLen = (size_t)(offsets[pivot + 1] - offsets[pivot]);
+
+					byDistance.resize(pending.end - pending.begin - 1);
+					Parallel::forRange(byDistance.size(), wide ? byDistance.size() : MIN_DISTANCES_PER_THREAD, [&](size_t begin, size_t end) {
+						for (size_t i = begin; i < end; ++i)
+						{
+							uint32_t entry = order[pending.begin + 1 + i];
+							size_t distance = Distance::levenshteinDistance(pivotStr, pivotLen,
+								pool.data() + offsets[entry], (size_t)(offsets[entry + 1] - offsets[entry]));
+							byDistance[i] = std::make_pair((uint32_t)distance, entry);
+						}
+					});
+					std::sort(byDistance.begin(), byDistance.end());
+
+					for (size_t i = 0; i < byDistance.size(); ++i)
+					{
+						size_t pos = pending.begin + 1 + i;
+						order[pos] = byDistance[i].second;
+						if (byDistance[i].first == 0)
+							continue;
+						if (groups[levelIndex].empty() || (groups[levelIndex].back().distance != byDistance[i].first))
+						{
+							ChildGroup group = { byDistance[i].first, pos, pos + 1 };
+							groups[levelIndex].push_back(group);
+						}
+						else
+						{
+							groups[levelIndex].back().end = pos + 1;
+						}
+					}
+				}
+			});
+
+			// Lay out the children of this level's nodes, in order, as the next level.
+			nextLevel.clear();
+			for (size_t levelIndex = 0; levelIndex < level.size(); ++levelIndex)
+			{
+				const PendingNode& pending = level[levelIndex];
+				const std::vector<ChildGroup>& children = groups[levelIndex];
+				uint32_t* node = nodes.data() + pending.node * NODE_WORDS;
+				node[FIRST_ENTRY] = (uint32_t)pending.begin;
+				node[NUM_ENTRIES] = (uint32_t)((children.empty() ? pending.end : children[0].begin) - pending.begin);
+				node[FIRST_CHILD] = (uint32_t)(nodes.size() / NODE_WORDS);
+				node[NUM_CHILDREN] = (uint32_t)children.size();
+
+				for (auto iter = children.begin(); iter != children.end(); ++iter)
+				{
+					PendingNode child = { nodes.size() / NODE_WORDS, iter->begin, iter->end };
+					nextLevel.push_back(child);
+					nodes.resize(nodes.size() + NODE_WORDS, 0);
+					nodes[child.node * NODE_WORDS + EDGE] = iter->distance;
+				}
+			}
+			level.swap(nextLevel);
+		}
+
+		// Copy everything into the flat layout.
+		size_t numNodes = nodes.size() / NODE_WORDS;
+		m_storage.assign(bufferSize(numStrings, numNodes, pool.size()) / sizeof(uint64_t), 0);
+		uint64_t* header = m_storage.data();
+		header[0] = MAGIC;
+		header[1] = numStrings;
+		header[2] = numNodes;
+		header[3] = pool.size();
+		if (!setPointers((const uint8_t*)m_storage.data(), m_storage.size() * sizeof(uint64_t)))
+			return false;
+		memcpy((void*)m_offsets, offsets.data(), offsets.size() * sizeof(uint64_t));
+		memcpy((void*)m_nodes, nodes.data(), nodes.size() * sizeof(uint32_t));
+		memcpy((void*)m_order, order.data(), order.size() * sizeof(uint32_t));
+		memcpy((void*)m_pool, pool.data(), pool.size());
+		return true;
+	}
+
+	bool BKTree::attach(const void* buffer, size_t bufferLen)
+	{
+		clear();
+
+		// Sanity check.
+		if ((buffer == NULL) || (bufferLen < HEADER_WORDS * sizeof(uint64_t)) || ((uintptr_t)buffer % sizeof(uint64_t) != 0))
+		{
+			return false;
+		}
+
+		// The queries use the offsets, nodes and order as indices, so a foreign or corrupted buffer must not get past here.
+		if (!setPointers((const uint8_t*)buffer, bufferLen) || !isConsistent())
+		{
+			clear();
+			return false;
+		}
+		return true;
+	}
+
+	bool BKTree::serialize(void* buffer, size_t bufferLen) const
+	{
+		// Sanity check.
+		if ((buffer == NULL) || (m_buffer == NULL) || (bufferLen < m_bufferLen))
+		{
+			return false;
+		}
+
+		memcpy(buffer, m_buffer, m_bufferLen);
+		return true;
+	}
+
+	const char* BKTree::entry(size_t index, size_t* len) const
+	{
+		// Sanity check.
+		if (index >= m_numStrings)
+		{
+			return NULL;
+		}
+
+		if (len)
+			*len = (size_t)(m_offsets[index + 1] - m_offsets[index]);
+		return m_pool + m_offsets[index];
+	}
+
+	size_t BKTree::within(const char* query, size_t k, std::vector<size_t>& indices, std::vector<size_t>* distances) const
+	{
+		// Sanity check.
+		if ((query == NULL) || (m_numNodes == 0))
+		{
+			return 0;
+		}
+
+		size_t queryLen = strlen(query);
+		size_t numFound = 0;
+		std::vector<uint32_t> stack(1, 0);
+		while (!stack.empty())
+		{
+			const uint32_t* node = m_nodes + stack.back() * NODE_WORDS;
+			stack.pop_back();
+
+			uint32_t pivot = m_order[node[FIRST_ENTRY]];
+			size_t distance = Distance::levenshteinDistance(query, queryLen,
+				m_pool + m_offsets[pivot], (size_t)(m_offsets[pivot + 1] - m_offsets[pivot]));
+			if (distance <= k)
+			{
+				for (size_t i = 0; i < node[NUM_ENTRIES]; ++i)
+				{
+					indices.push_back(m_order[node[FIRST_ENTRY] + i]);
+					if (distances)
+						distances->push_back(distance);
+				}
+				numFound += node[NUM_ENTRIES];
+			}
+
+			// By the triangle inequality, matches can only be in children whose distance to this node is within k of
+			// the query's. Children are sorted by that distance.
+			size_t lowest = (distance > k) ? distance - k : 0;
+			size_t highest = distance + k;
+			const uint32_t* child = m_nodes + node[FIRST_CHILD] * NODE_WORDS;
+			for (size_t i = 0; i < node[NUM_CHILDREN]; ++i, child += NODE_WORDS)
+			{
+				if (child[EDGE] > highest)
+					break;
+				if (child[EDGE] >= lowest)
+					stack.push_back(node[FIRST_CHILD] + (uint32_t)i);
+			}
+		}
+		return numFound;
+	}
+
+	void BKTree::withinBatch(const char* const* queries, size_t numQueries, size_t k, std::vector<std::vector<size_t> >& results) const
+	{
+		results.assign(numQueries, std::vector<size_t>());
+
+		// Sanity check.
+		if (queries == NULL)
+		{
+			return;
+		}
+
+		Parallel::forRange(numQueries, 16, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				within(queries[i], k, results[i]);
+			}
+		});
+	}
+}
@@ -0,0 +1,111 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _BKTREE_
+#define _BKTREE_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace LibMath
+{
+	/**
+	 * Static BK-tree over a dictionary of strings, for finding every entry within a given Levenshtein distance of a
+	 * query. Entries that are the same distance from a node's string share a subtree, so a query only has to descend
+	 * into subtrees whose distance is within k of its own distance to that node.
+	 *
+	 * As with GeoIndex, the whole tree (strings included) lives in one flat buffer that can be written out with
+	 * serialize() and used in place with attach(). The buffer uses the native byte order.
+	 */
+	class BKTree
+	{
+	public:
+		BKTree();
+		virtual ~BKTree(void);
+
+		/**
+		 * Builds the tree over 'numStrings' NULL terminated strings, one level at a time, with the distances at each
+		 * level computed in parallel. Query results refer to entries by their position in 'strings'.
+		 */
+		bool build(const char* const* strings, size_t numStrings);
+
+		/**
+		 * Uses a buffer produced by serialize() in place, without copying it. The buffer must be 8 byte aligned and must
+		 * outlive this object (or the next call to build/attach). Returns FALSE if the buffer doesn't hold a valid tree.
+		 */
+		bool attach(const void* buffer, size_t bufferLen);
+
+		/**
+		 * Returns the number of bytes needed by serialize().
+		 */
+		size_t serializedSize(void) const { return m_bufferLen; }
+
+		/**
+		 * Copies the tree to 'buffer'. Returns FALSE if the buffer is too small.
+		 */
+		bool serialize(void* buffer, size_t bufferLen) const;
+
+		/**
+		 * Returns the number of entries in the tree.
+		 */
+		size_t size(void) const { return m_numStrings; }
+
+		/**
+		 * Returns the entry at the given position, and its length.
+		 */
+		const char* entry(size_t index, size_t* len = NULL) const;
+
+		/**
+		 * Finds every entry within Levenshtein distance k of 'query', in no particular order. Appends their indices to
+		 * 'indices' and, if not NULL, their distances to 'distances'. Returns the number of entries found.
+		 */
+		size_t within(const char* query, size_t k, std::vector<size_t>& indices, std::vector<size_t>* distances = NULL) const;
+
+		/**
+		 * Runs within() for each of 'numQueries' queries, spread across threads. results[i] receives the indices
+		 * of the entries that match queries[i].
+		 */
+		void withinBatch(const char* const* queries, size_t numQueries, size_t k, std::vector<std::vector<size_t> >& results) const;
+
+	private:
+		std::vector<uint64_t> m_storage;    // owned buffer, when built rather than attached
+		const uint8_t*        m_buffer;
+		size_t                m_bufferLen;
+		size_t                m_numStrings;
+		size_t                m_numNodes;
+		const uint64_t*       m_offsets;    // start of each entry in m_pool, plus the end of the last one
+		const uint32_t*       m_nodes;      // five words per node: first entry, number of entries, first child, number of children, distance to parent
+		const uint32_t*       m_order;      // entry indices, grouped by node
+		const char*           m_pool;       // entry text, in their original order
+
+		void clear(void);
+		bool setPointers(const uint8_t* buffer, size_t bufferLen);
+		bool isConsistent(void) const;
+
+		BKTree(const BKTree&);
+		BKTree& operator=(const BKTree&);
+	};
+}
+
+#endif
@@ -20,6 +20,7 @@
 // SOFTWARE.
 
 #include <iomanip>
+#include <string.h>
 #include <sstream>
 #include <string>
 #include <random>
@@ -24,6 +24,7 @@
 #ifndef _CALCULUS_
 #define _CALCULUS_
 
+#include <stdlib.h>
 #include <vector>
 
 namespace LibMath
@@ -0,0 +1,318 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DBSCAN.h"
+#include "Distance.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace LibMath
+{
+	const size_t DBSCAN::NOISE;
+
+	namespace
+	{
+	/// Uniform grid over points in a low dimensional Euclidian space. Points are sorted by cell so that the
+	/// contents of a cell are contiguous. Cells are found through a hash of their integer coordinates; two cells
+	/// that happen to share a hash are treated as one, which only adds candidates, so callers must always check
+	/// the exact distance.
+	class GridIndex
+	{
+	public:
+		GridIndex(const double* points, size_t numPoints, size_t dimensions, double cellSize)
+		{
+			const size_t MIN_POINTS_PER_THREAD = 8192;
+
+			m_dimensions = dimensions;
+			m_cells.resize(numPoints * dimensions);
+
+			std::vector<std::pair<uint64_t, size_t> > keys(numPoints);
+			Parallel::forRange(numPoints, MIN_POINTS_PER_THREAD, [&](size_t begin, size_t end) {
+				for (size_t pointIndex = begin; pointIndex < end; ++pointIndex)
+				{
+					int64_t* cell = m_cells.data() + pointIndex * dimensions;
+					for (size_t i = 0; i < dimensions; ++i)
+						cell[i] = (int64_t)floor(points[pointIndex * dimensions + i] / cellSize);
+					keys[pointIndex] = std::make_pair(hash(cell), pointIndex);
+				}
+			});
+			std::sort(keys.begin(), keys.end());
+
+			m_order.resize(numPoints);
+			for (size_t i = 0; i < numPoints; ++i)
+			{
+				m_order[i] = keys[i].second;
+				if ((i == 0) || (keys[i].first != keys[i - 1].first))
+					m_ranges[keys[i].first] = std::make_pair(i, i + 1);
+				else
+					m_ranges[keys[i].first].second = i + 1;
+			}
+
+			m_numNeighborCells = 1;
+			for (size_t i = 0; i < dimensions; ++i)
+				m_numNeighborCells *= 3;
+		}
+
+		/// Working space for forEachCandidate, made once per thread so that the queries themselves don't allocate.
+		struct Scratch
+		{
+			std::vector<int64_t> cell;
+			std::vector<uint64_t> neighborKeys;
+		};
+
+		Scratch makeScratch(void) const
+		{
+			Scratch scratch;
+			scratch.cell.resize(m_dimensions);
+			scratch.neighborKeys.reserve(m_numNeighborCells);
+			return scratch;
+		}
+
+		/// Calls fn(candidateIndex) for every point in the cell containing 'pointIndex' and the cells around it,
+		/// including the point itself. Stops early if fn returns false.
+		template <typename Fn>
+		void forEachCandidate(size_t pointIndex, Scratch& scratch, Fn fn) const
+		{
+			std::vector<int64_t>& cell = scratch.cell;
+			std::vector<uint64_t>& neighborKeys = scratch.neighborKeys;
+			neighborKeys.clear();
+
+			const int64_t* center = m_cells.data() + pointIndex * m_dimensions;
+			for (size_t neighbor = 0; neighbor < m_numNeighborCells; ++neighbor)
+			{
+				size_t temp = neighbor;
+				for (size_t i = 0; i < m_dimensions; ++i)
+				{
+					cell[i] = center[i] + (int64_t)(temp % 3) - 1;
+					temp /= 3;
+				}
+				neighborKeys.push_back(hash(cell.data()));
+			}
+
+			// Don't visit the same bucket twice if two of the cells share a hash.
+			std::sort(neighborKeys.begin(), neighborKeys.end());
+			neighborKeys.erase(std::unique(neighborKeys.begin(), neighborKeys.end()), neighborKeys.end());
+
+			for (auto keyIter = neighborKeys.begin(); keyIter != neighborKeys.end(); ++keyIter)
+			{
+				auto rangeIter = m_ranges.find(*keyIter);
+				if (rangeIter == m_ranges.end())
+					continue;
+				for (size_t i = rangeIter->second.first; i < rangeIter->second.second; ++i)
+				{
+					if (!fn(m_order[i]))
+						return;
+				}
+			}
+		}
+
+	private:
+		size_t m_dimensions;
+		size_t m_numNeighborCells;
+		std::vector<int64_t> m_cells;
+		std::vector<size_t> m_order;
+		std::unordered_map<uint64_t, std::pair<size_t, size_t> > m_ranges;
+
+		uint64_t hash(const int64_t* cell) const
+		{
+			uint64_t h = 0xcbf29ce484222325ULL;
+			for (size_t i = 0; i < m_dimensions; ++i)
+			{
+				h ^= (uint64_t)cell[i] + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+				h *= 0x100000001b3ULL;
+			}
+			return h;
+		}
+	};
+	}
+
+	/// Lock free union-find. Roots are always linked beneath the smaller index, so the root of a set is its smallest member.
+	static size_t findRoot(std::vector<std::atomic<size_t> >& parents, size_t x)
+	{
+		while (true)
+		{
+			size_t parent = parents[x].load();
+			if (parent == x)
+				return x;
+			size_t grandparent = parents[parent].load();
+			if (grandparent != parent)
+				parents[x].compare_exchange_weak(parent, grandparent); // Path halving; fine if another thread beat us to it.
+			x = grandparent;
+		}
+	}
+
+	static void unite(std::vector<std::atomic<size_t> >& parents, size_t a, size_t b)
+	{
+		while (true)
+		{
+			a = findRoot(parents, a);
+			b = findRoot(parents, b);
+			if (a == b)
+				return;
+			if (a < b)
+				std::swap(a, b);
+
+			// Only succeeds if 'a' is still a root.
+			size_t expected = a;
+			if (parents[a].compare_exchange_strong(expected, b))
+				return;
+		}
+	}
+
+	template <typename Within>
+	static size_t runDBSCAN(const GridIndex& index, size_t dataLen, size_t minPoints, Within within, size_t* tags)
+	{
+		const size_t MIN_POINTS_PER_THREAD = 1024;
+
+		// Find the core points.
+		std::vector<char> isCore(dataLen, 0);
+		Parallel::forRange(dataLen, MIN_POINTS_PER_THREAD, [&](size_t begin, size_t end) {
+			GridIndex::Scratch scratch = index.makeScratch();
+			for (size_t pointIndex = begin; pointIndex < end; ++pointIndex)
+			{
+				size_t numNeighbors = 0;
+				index.forEachCandidate(pointIndex, scratch, [&](size_t candidate) {
+					if (within(pointIndex, candidate))
+						++numNeighbors;
+					return numNeighbors < minPoints;
+				});
+				isCore[pointIndex] = (numNeighbors >= minPoints) ? 1 : 0;
+			}
+		});
+
+		// Merge core points that are within reach of each other.
+		std::vector<std::atomic<size_t> > parents(dataLen);
+		for (size_t pointIndex = 0; pointIndex < dataLen; ++pointIndex)
+			parents[pointIndex].store(pointIndex);
+		Parallel::forRange(dataLen, MIN_POINTS_PER_THREAD, [&](size_t begin, size_t end) {
+			GridIndex::Scratch scratch = index.makeScratch();
+			for (size_t pointIndex = begin; pointIndex < end; ++pointIndex)
+			{
+				if (!isCore[pointIndex])
+					continue;
+				index.forEachCandidate(pointIndex, scratch, [&](size_t candidate) {
+					if ((candidate < pointIndex) && isCore[candidate] &&
+						(findRoot(parents, candidate) != findRoot(parents, pointIndex)) && within(pointIndex, candidate))
+					{
+						unite(parents, pointIndex, candidate);
+					}
+					return true;
+				});
+			}
+		});
+
+		// Border points join the cluster of their lowest numbered core neighbor.
+		std::vector<size_t> owners(dataLen, DBSCAN::NOISE);
+		Parallel::forRange(dataLen, MIN_POINTS_PER_THREAD, [&](size_t begin, size_t end) {
+			GridIndex::Scratch scratch = index.makeScratch();
+			for (size_t pointIndex = begin; pointIndex < end; ++pointIndex)
+			{
+				if (isCore[pointIndex])
+				{
+					owners[pointIndex] = pointIndex;
+					continue;
+				}
+				index.forEachCandidate(pointIndex, scratch, [&](size_t candidate) {
+					if (isCore[candidate] && (candidate < owners[pointIndex]) && within(pointIndex, candidate))
+						owners[pointIndex] = candidate;
+					return true;
+				});
+			}
+		});
+
+		// Number the clusters in order of their first point.
+		size_t numClusters = 0;
+		std::vector<size_t> labels(dataLen, DBSCAN::NOISE);
+		for (size_t pointIndex = 0; pointIndex < dataLen; ++pointIndex)
+		{
+			if (owners[pointIndex] == DBSCAN::NOISE)
+			{
+				tags[pointIndex] = DBSCAN::NOISE;
+				continue;
+			}
+
+			size_t root = findRoot(parents, owners[pointIndex]);
+			if (labels[root] == DBSCAN::NOISE)
+				labels[root] = numClusters++;
+			tags[pointIndex] = labels[root];
+		}
+		return numClusters;
+	}
+
+	size_t DBSCAN::dbscan(const double* data, size_t dataLen, size_t dimensions, double eps, size_t minPoints, size_t* tags)
+	{
+		// Sanity check.
+		if ((dataLen == 0) || (dimensions == 0) || !(eps > (double)0.0))
+		{
+			return 0;
+		}
+
+		GridIndex index(data, dataLen, dimensions, eps);
+		double epsSquared = eps * eps;
+		return runDBSCAN(index, dataLen, minPoints, [&](size_t a, size_t b) {
+			double sum = (double)0.0;
+			for (size_t i = 0; i < dimensions; ++i)
+			{
+				double diff = data[a * dimensions + i] - data[b * dimensions + i];
+				sum += diff * diff;
+			}
+			return sum <= epsSquared;
+		}, tags);
+	}
+
+	size_t DBSCAN::dbscanHaversine(const double* lat, const double* lon, size_t dataLen, double epsMeters, size_t minPoints, size_t* tags)
+	{
+		const double R = Distance::EARTH_RADIUS;
+		const double pi = (double)(3.141592653589793238);
+
+		// Sanity check.
+		if ((dataLen == 0) || !(epsMeters > (double)0.0))
+		{
+			return 0;
+		}
+
+		// Index the points by their position on a sphere of radius R. Two points that are 'epsMeters' apart along the
+		// surface are a chord of 2R sin(eps / 2R) apart in 3D, so that is the grid spacing.
+		std::vector<double> xyz(dataLen * 3);
+		for (size_t pointIndex = 0; pointIndex < dataLen; ++pointIndex)
+		{
+			double* point = xyz.data() + pointIndex * 3;
+			Distance::toUnitVector(lat[pointIndex], lon[pointIndex], point);
+			point[0] *= R;
+			point[1] *= R;
+			point[2] *= R;
+		}
+		double angle = epsMeters / R;
+		double chord = (angle < pi) ? (double)2.0 * R * sin((double)0.5 * angle) : (double)2.0 * R;
+
+		// Pad the cells slightly so that rounding in the projection can't hide a neighbor; the exact check is the haversine distance.
+		GridIndex index(xyz.data(), dataLen, 3, chord * (double)1.000001);
+		return runDBSCAN(index, dataLen, minPoints, [&](size_t a, size_t b) {
+			return Distance::haversineDistance(lat[a], lon[a], (double)0.0, lat[b], lon[b], (double)0.0) <= epsMeters;
+		}, tags);
+	}
+}
@@ -0,0 +1,66 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _DBSCAN_
+#define _DBSCAN_
+
+#include <stdlib.h>
+
+namespace LibMath
+{
+	/**
+	 * Density based clustering (Ester et al., "A Density-Based Algorithm for Discovering Clusters", 1996).
+	 * Unlike K Means, the number of clusters does not need to be known up front, and points that are not in a dense
+	 * region are reported as noise instead of being forced into a cluster.
+	 *
+	 * Neighborhood queries go through a uniform grid with cells 'eps' wide, so each query only looks at the adjacent
+	 * cells instead of every other point. The neighbor searches, and the merging of core points into clusters, are
+	 * spread across threads. Results do not depend on the number of threads.
+	 */
+	class DBSCAN
+	{
+	public:
+		/**
+		 * Tag given to points that do not belong to any cluster.
+		 */
+		static const size_t NOISE = (size_t)-1;
+
+		/**
+		 * Clusters 'dataLen' points, each with 'dimensions' values (stored row-major), using Euclidian distance.
+		 * A point is a core point if at least 'minPoints' points (including itself) are within 'eps' of it.
+		 * Writes the cluster of each point (or NOISE) to 'tags'. Clusters are numbered from zero, in order of
+		 * their first point. Returns the number of clusters. The grid has 3^dimensions neighbors per cell, so this
+		 * is intended for low dimensional data.
+		 */
+		static size_t dbscan(const double* data, size_t dataLen, size_t dimensions, double eps, size_t minPoints, size_t* tags);
+
+		/**
+		 * Clusters 'dataLen' latitude/longitude pairs (in degrees), using the same great circle distance as
+		 * Distance::haversineDistance (at zero altitude). 'epsMeters' is the neighborhood radius, in meters.
+		 * Writes the cluster of each point (or NOISE) to 'tags'. Returns the number of clusters.
+		 */
+		static size_t dbscanHaversine(const double* lat, const double* lon, size_t dataLen, double epsMeters, size_t minPoints, size_t* tags);
+	};
+}
+
+#endif
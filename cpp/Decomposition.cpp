@@ -0,0 +1,557 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Decomposition.h"
+#include "Gemm.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace LibMath
+{
+	namespace
+	{
+	/// Columns per panel. Panels are factored with vector operations; everything else is a matrix product.
+	const size_t BLOCK = 64;
+
+	/**
+	 * Solves MX = B in place (X holds B on entry), where M is n x n triangular and is T, or T's transpose when
+	 * 'transposed' is set. 'lower' describes M. Block rows are eliminated with a matrix product against the rows
+	 * already solved, then finished by substitution within the block.
+	 */
+	void solveTriangular(bool lower, bool transposed, bool unitDiagonal, size_t n, const double* T, size_t ldt,
+		double* X, size_t ldx, size_t nrhs)
+	{
+		if ((n == 0) || (nrhs == 0))
+			return;
+
+		// Elements of M.
+		auto m = [&](size_t i, size_t j) { return transposed ? T[j * ldt + i] : T[i * ldt + j]; };
+
+		size_t numBlocks = (n + BLOCK - 1) / BLOCK;
+		for (size_t b = 0; b < numBlocks; ++b)
+		{
+			// Forward substitution runs top down, backward substitution bottom up.
+			size_t block = lower ? b : (numBlocks - 1 - b);
+			size_t i0 = block * BLOCK;
+			size_t i1 = std::min(n, i0 + BLOCK);
+			double* Xi0 = X + i0 * ldx;
+
+			if (lower && (i0 > 0))
+			{
+				const double* M = transposed ? (T + i0) : (T + i0 * ldt);
+				Gemm::multiply(transposed, false, i1 - i0, nrhs, i0, (double)-1.0, M, ldt, X, ldx, (double)1.0, Xi0, ldx);
+			}
+			else if (!lower && (i1 < n))
+			{
+				const double* M = transposed ? (T + i1 * ldt + i0) : (T + i0 * ldt + i1);
+				Gemm::multiply(transposed, false, i1 - i0, nrhs, n - i1, (double)-1.0, M, ldt, X + i1 * ldx, ldx, (double)1.0, Xi0, ldx);
+			}
+
+			for (size_t step = 0; step < i1 - i0; ++step)
+			{
+				size_t i = lower ? (i0 + step) : (i1 - 1 - step);
+				double* Xi = X + i * ldx;
+				size_t p0 = lower ? i0 : i + 1;
+				size_t p1 = lower ? i : i1;
+				for (size_t p = p0; p < p1; ++p)
+				{
+					double mip = m(i, p);
+					const double* Xp = X + p * ldx;
+					for (size_t c = 0; c < nrhs; ++c)
+						Xi[c] -= mip * Xp[c];
+				}
+				if (!unitDiagonal)
+				{
+					double scale = (double)1.0 / m(i, i);
+					for (size_t c = 0; c < nrhs; ++c)
+						Xi[c] *= scale;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Applies the transpose of the block reflector built from reflectors k0 .. k0+kb of a QR factorization to the
+	 * 'rows' x 'nc' matrix C: C = (I - V T V^T)^T C, with V the reflectors (unit lower trapezoidal) and T the
+	 * kb x kb upper triangular factor of the compact WY form.
+	 */
+	void applyBlockReflector(const double* a, size_t lda, size_t k0, size_t kb, size_t rows, const double* tau,
+		double* C, size_t ldc, size_t nc)
+	{
+		std::vector<double> V(rows * kb);
+		std::vector<double> G(kb * kb);
+		std::vector<double> T(kb * kb, (double)0.0);
+		std::vector<double> W(kb * nc);
+		std::vector<double> TW(kb * nc);
+
+		for (size_t r = 0; r < rows; ++r)
+		{
+			const double* rowA = a + (k0 + r) * lda + k0;
+			for (size_t c = 0; c < kb; ++c)
+				V[r * kb + c] = (r == c) ? (double)1.0 : ((r > c) ? rowA[c] : (double)0.0);
+		}
+
+		// T[0:j, j] = -tau_j T[0:j, 0:j] V[:, 0:j]^T v_j, with the inner products taken from G = V^T V.
+		Gemm::multiply(true, false, kb, kb, rows, (double)1.0, V.data(), kb, V.data(), kb, (double)0.0, G.data(), kb);
+		for (size_t j = 0; j < kb; ++j)
+		{
+			T[j * kb + j] = tau[k0 + j];
+			for (size_t p = 0; p < j; ++p)
+			{
+				double sum = (double)0.0;
+				for (size_t q = p; q < j; ++q)
+					sum += T[p * kb + q] * G[q * kb + j];
+				T[p * kb + j] = -tau[k0 + j] * sum;
+			}
+		}
+
+		// C -= V (T^T (V^T C))
+		Gemm::multiply(true, false, kb, nc, rows, (double)1.0, V.data(), kb, C, ldc, (double)0.0, W.data(), nc);
+		Gemm::multiply(true, false, kb, nc, kb, (double)1.0, T.data(), kb, W.data(), nc, (double)0.0, TW.data(), nc);
+		Gemm::multiply(false, false, rows, nc, kb, (double)-1.0, V.data(), kb, TW.data(), nc, (double)1.0, C, ldc);
+	}
+	}
+
+	//
+	// LUDecomposition
+	//
+
+	LUDecomposition::LUDecomposition(void)
+	{
+		m_singular = true;
+	}
+
+	bool LUDecomposition::factor(const SquareMatrix* A)
+	{
+		size_t n = A->size();
+		m_lu = *A;
+		m_pivots.assign(n, 0);
+		m_singular = false;
+
+		double* a = m_lu.row(0);
+		size_t lda = m_lu.stride();
+
+		for (size_t k0 = 0; k0 < n; k0 += BLOCK)
+		{
+			size_t k1 = std::min(n, k0 + BLOCK);
+
+			// Factor the panel of columns k0 .. k1, swapping whole rows as pivots are chosen.
+			for (size_t j = k0; j < k1; ++j)
+			{
+				size_t pivot = j;
+				for (size_t i = j + 1; i < n; ++i)
+				{
+					if (fabs(a[i * lda + j]) > fabs(a[pivot * lda + j]))
+						pivot = i;
+				}
+				m_pivots[j] = pivot;
+				if (pivot != j)
+					std::swap_ranges(a + j * lda, a + j * lda + n, a + pivot * lda);
+
+				const double* rowJ = a + j * lda;
+				if (rowJ[j] == (double)0.0)
+				{
+					m_singular = true;
+					continue;
+				}
+
+				double scale = (double)1.0 / rowJ[j];
+				for (size_t i = j + 1; i < n; ++i)
+				{
+					double* rowI = a + i * lda;
+					double l = rowI[j] * scale;
+					rowI[j] = l;
+					for (size_t c = j + 1; c < k1; ++c)
+						rowI[c] -= l * rowJ[c];
+				}
+			}
+
+			if (k1 < n)
+			{
+				// U12 = L11^-1 A12, then A22 -= L21 U12.
+				solveTriangular(true, false, true, k1 - k0, a + k0 * lda + k0, lda, a + k0 * lda + k1, lda, n - k1);
+				Gemm::multiply(false, false, n - k1, n - k1, k1 - k0, (double)-1.0, a + k1 * lda + k0, lda, a + k0 * lda + k1, lda,
+					(double)1.0, a + k1 * lda + k1, lda);
+			}
+		}
+		return !m_singular;
+	}
+
+	bool LUDecomposition::solve(const Vector* b, Vector* x) const
+	{
+		size_t n = m_lu.size();
+
+		// Sanity check.
+		if ((b->size() != n) || (x->size() != n))
+			return false;
+
+		*x = *b;
+		for (size_t i = 0; i < n; ++i)
+			std::swap(x->m_data[i], x->m_data[m_pivots[i]]);
+		solveTriangular(true, false, true, n, m_lu.row(0), m_lu.stride(), x->m_data, 1, 1);
+		solveTriangular(false, false, false, n, m_lu.row(0), m_lu.stride(), x->m_data, 1, 1);
+		return true;
+	}
+
+	bool LUDecomposition::solve(const Matrix* B, Matrix* X) const
+	{
+		size_t n = m_lu.size();
+
+		// Sanity check.
+		if ((B->width() != n) || (X->width() != n) || (X->height() != B->height()))
+			return false;
+
+		*X = *B;
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (m_pivots[i] != i)
+				std::swap_ranges(X->row(i), X->row(i) + X->height(), X->row(m_pivots[i]));
+		}
+		solveTriangular(true, false, true, n, m_lu.row(0), m_lu.stride(), X->row(0), X->stride(), X->height());
+		solveTriangular(false, false, false, n, m_lu.row(0), m_lu.stride(), X->row(0), X->stride(), X->height());
+		return true;
+	}
+
+	double LUDecomposition::determinant(void) const
+	{
+		if (m_singular)
+			return (double)0.0;
+
+		double det = (double)1.0;
+		for (size_t i = 0; i < m_lu.size(); ++i)
+		{
+			det *= m_lu.get(i, i);
+			if (m_pivots[i] != i)
+				det = -det;
+		}
+		return det;
+	}
+
+	bool LUDecomposition::inverse(SquareMatrix* result) const
+	{
+		// Sanity check.
+		if (m_singular || (result->size() != m_lu.size()))
+			return false;
+
+		result->identity();
+		return solve(result, result);
+	}
+
+	//
+	// CholeskyDecomposition
+	//
+
+	CholeskyDecomposition::CholeskyDecomposition(void)
+	{
+		m_valid = false;
+	}
+
+	bool CholeskyDecomposition::factor(const SquareMatrix* A)
+	{
+		size_t n = A->size();
+		m_l = *A;
+		m_valid = false;
+
+		double* a = m_l.row(0);
+		size_t lda = m_l.stride();
+
+		for (size_t k0 = 0; k0 < n; k0 += BLOCK)
+		{
+			size_t k1 = std::min(n, k0 + BLOCK);
+
+			// Factor the diagonal block; earlier trailing updates have already been applied to it.
+			for (size_t j = k0; j < k1; ++j)
+			{
+				double* rowJ = a + j * lda;
+				double d = rowJ[j];
+				for (size_t p = k0; p < j; ++p)
+					d -= rowJ[p] * rowJ[p];
+				if (!(d > (double)0.0))
+					return false;
+				d = sqrt(d);
+				rowJ[j] = d;
+
+				for (size_t i = j + 1; i < k1; ++i)
+				{
+					double* rowI = a + i * lda;
+					double sum = rowI[j];
+					for (size_t p = k0; p < j; ++p)
+						sum -= rowI[p] * rowJ[p];
+					rowI[j] = sum / d;
+				}
+			}
+
+			if (k1 < n)
+			{
+				// L21 = A21 L11^-T, one row at a time.
+				for (size_t i = k1; i < n; ++i)
+				{
+					double* rowI = a + i * lda;
+					for (size_t j = k0; j < k1; ++j)
+					{
+						const double* rowJ = a + j * lda;
+						double sum = rowI[j];
+						for (size_t p = k0; p < j; ++p)
+							sum -= rowI[p] * rowJ[p];
+						rowI[j] = sum / rowJ[j];
+					}
+				}
+
+				// A22 -= L21 L21^T, one block row at a time and only up to the diagonal.
+				for (size_t r0 = k1; r0 < n; r0 += BLOCK)
+				{
+					size_t r1 = std::min(n, r0 + BLOCK);
+					Gemm::multiply(false, true, r1 - r0, r1 - k1, k1 - k0, (double)-1.0, a + r0 * lda + k0, lda, a + k1 * lda + k0, lda,
+						(double)1.0, a + r0 * lda + k1, lda);
+				}
+			}
+		}
+
+		// The upper triangle still holds whatever A had there.
+		for (size_t i = 0; i < n; ++i)
+			std::fill(a + i * lda + i + 1, a + i * lda + n, (double)0.0);
+
+		m_valid = true;
+		return true;
+	}
+
+	bool CholeskyDecomposition::solve(const Vector* b, Vector* x) const
+	{
+		size_t n = m_l.size();
+
+		// Sanity check.
+		if (!m_valid || (b->size() != n) || (x->size() != n))
+			return false;
+
+		*x = *b;
+		solveTriangular(true, false, false, n, m_l.row(0), m_l.stride(), x->m_data, 1, 1);
+		solveTriangular(false, true, false, n, m_l.row(0), m_l.stride(), x->m_data, 1, 1);
+		return true;
+	}
+
+	bool CholeskyDecomposition::solve(const Matrix* B, Matrix* X) const
+	{
+		size_t n = m_l.size();
+
+		// Sanity check.
+		if (!m_valid || (B->width() != n) || (X->width() != n) || (X->height() != B->height()))
+			return false;
+
+		*X = *B;
+		solveTriangular(true, false, false, n, m_l.row(0), m_l.stride(), X->row(0), X->stride(), X->height());
+		solveTriangular(false, true, false, n, m_l.row(0), m_l.stride(), X->row(0), X->stride(), X->height());
+		return true;
+	}
+
+	double CholeskyDecomposition::determinant(void) const
+	{
+		if (!m_valid)
+			return (double)0.0;
+
+		double det = (double)1.0;
+		for (size_t i = 0; i < m_l.size(); ++i)
+			det *= m_l.get(i, i) * m_l.get(i, i);
+		return det;
+	}
+
+	bool CholeskyDecomposition::inverse(SquareMatrix* result) const
+	{
+		// Sanity check.
+		if (!m_valid || (result->size() != m_l.size()))
+			return false;
+
+		result->identity();
+		return solve(result, result);
+	}
+
+	//
+	// QRDecomposition
+	//
+
+	QRDecomposition::QRDecomposition(void)
+	{
+		m_valid = false;
+	}
+
+	bool QRDecomposition::factor(const Matrix* A)
+	{
+		size_t m = A->width();
+		size_t n = A->height();
+
+		// Sanity check.
+		m_valid = false;
+		if (n > m)
+			return false;
+
+		m_qr = *A;
+		m_tau.assign(n, (double)0.0);
+
+		double* a = m_qr.row(0);
+		size_t lda = m_qr.stride();
+		std::vector<double> w(BLOCK);
+
+		for (size_t k0 = 0; k0 < n; k0 += BLOCK)
+		{
+			size_t k1 = std::min(n, k0 + BLOCK);
+
+			// Reduce the panel one column at a time, applying each reflector to the rest of the panel.
+			for (size_t j = k0; j < k1; ++j)
+			{
+				double alpha = a[j * lda + j];
+				double sigma = (double)0.0;
+				for (size_t i = j + 1; i < m; ++i)
+					sigma += a[i * lda + j] * a[i * lda + j];
+				if (sigma == (double)0.0)
+					continue;
+
+				double norm = sqrt(alpha * alpha + sigma);
+				double beta = (alpha >= (double)0.0) ? -norm : norm;
+				double tau = (beta - alpha) / beta;
+				double scale = (double)1.0 / (alpha - beta);
+				for (size_t i = j + 1; i < m; ++i)
+					a[i * lda + j] *= scale;
+				a[j * lda + j] = beta;
+				m_tau[j] = tau;
+
+				if (j + 1 < k1)
+				{
+					size_t width = k1 - j - 1;
+					const double* rowJ = a + j * lda + j + 1;
+					for (size_t c = 0; c < width; ++c)
+						w[c] = rowJ[c];
+					for (size_t i = j + 1; i < m; ++i)
+					{
+						const double* rowI = a + i * lda;
+						double v = rowI[j];
+						for (size_t c = 0; c < width; ++c)
+							w[c] += v * rowI[j + 1 + c];
+					}
+					for (size_t i = j; i < m; ++i)
+					{
+						double* rowI = a + i * lda;
+						double v = (i == j) ? (double)1.0 : rowI[j];
+						for (size_t c = 0; c < width; ++c)
+							rowI[j + 1 + c] -= tau * v * w[c];
+					}
+				}
+			}
+
+			// Apply the whole panel's reflectors to the columns to its right in one block.
+			if (k1 < n)
+				applyBlockReflector(a, lda, k0, k1 - k0, m - k0, m_tau.data(), a + k0 * lda + k1, lda, n - k1);
+		}
+
+		m_valid = true;
+		return true;
+	}
+
+	void QRDecomposition::applyQTranspose(Matrix* B) const
+	{
+		size_t m = m_qr.width();
+		size_t n = m_qr.height();
+		for (size_t k0 = 0; k0 < n; k0 += BLOCK)
+		{
+			size_t k1 = std::min(n, k0 + BLOCK);
+			applyBlockReflector(m_qr.row(0), m_qr.stride(), k0, k1 - k0, m - k0, m_tau.data(), B->row(k0), B->stride(), B->height());
+		}
+	}
+
+	bool QRDecomposition::solve(const Matrix* B, Matrix* X) const
+	{
+		size_t m = m_qr.width();
+		size_t n = m_qr.height();
+
+		// Sanity check.
+		if (!m_valid || (B->width() != m) || (X->width() != n) || (X->height() != B->height()))
+			return false;
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (m_qr.get(i, i) == (double)0.0)
+				return false;
+		}
+
+		// x = R^-1 (Q^T b), using the first n rows of Q^T b.
+		Matrix Y(*B);
+		applyQTranspose(&Y);
+		solveTriangular(false, false, false, n, m_qr.row(0), m_qr.stride(), Y.row(0), Y.stride(), Y.height());
+		for (size_t i = 0; i < n; ++i)
+			std::copy(Y.row(i), Y.row(i) + Y.height(), X->row(i));
+		return true;
+	}
+
+	bool QRDecomposition::solve(const Vector* b, Vector* x) const
+	{
+		// Sanity check.
+		if ((b->size() != m_qr.width()) || (x->size() != m_qr.height()))
+			return false;
+
+		Matrix B(b->size(), 1);
+		Matrix X(x->size(), 1);
+		for (size_t i = 0; i < b->size(); ++i)
+			B.set(i, 0, b->m_data[i]);
+		if (!solve(&B, &X))
+			return false;
+		for (size_t i = 0; i < x->size(); ++i)
+			x->m_data[i] = X.get(i, 0);
+		return true;
+	}
+
+	double QRDecomposition::determinant(void) const
+	{
+		// Sanity check.
+		if (!m_valid || (m_qr.width() != m_qr.height()))
+			return (double)0.0;
+
+		// Each reflector that isn't the identity has a determinant of -1.
+		double det = (double)1.0;
+		for (size_t i = 0; i < m_qr.height(); ++i)
+		{
+			det *= m_qr.get(i, i);
+			if (m_tau[i] != (double)0.0)
+				det = -det;
+		}
+		return det;
+	}
+
+	bool QRDecomposition::inverse(SquareMatrix* result) const
+	{
+		// Sanity check.
+		if (!m_valid || (m_qr.width() != m_qr.height()) || (result->size() != m_qr.height()))
+			return false;
+
+		result->identity();
+		return solve(result, result);
+	}
+
+	void QRDecomposition::r(Matrix* R) const
+	{
+		size_t n = m_qr.height();
+
+		// Sanity check.
+		if ((R->width() != n) || (R->height() != n))
+			return;
+
+		for (size_t i = 0; i < n; ++i)
+			for (size_t j = 0; j < n; ++j)
+				R->set(i, j, (j >= i) ? m_qr.get(i, j) : (double)0.0);
+	}
+}
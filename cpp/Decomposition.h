@@ -0,0 +1,144 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _DECOMPOSITION_
+#define _DECOMPOSITION_
+
+#include <stdlib.h>
+#include <vector>
+#include "SquareMatrix.h"
+
+namespace LibMath
+{
+	/**
+	 * LU decomposition with partial pivoting, PA = LU. Factor once, then solve for as many right hand sides as needed.
+	 * The factorization is blocked and right-looking: each panel of columns is factored on its own and the rest of
+	 * the matrix is updated with one matrix product, so most of the work runs in the GEMM kernel.
+	 */
+	class LUDecomposition
+	{
+	public:
+		LUDecomposition(void);
+
+		/**
+		 * Factors A. Returns false if A is singular, in which case solve and inverse are meaningless.
+		 */
+		bool factor(const SquareMatrix* A);
+
+		/**
+		 * Solves Ax = b. Returns false if the sizes don't match the factored matrix.
+		 */
+		bool solve(const Vector* b, Vector* x) const;
+
+		/**
+		 * Solves AX = B for every column of B at once.
+		 */
+		bool solve(const Matrix* B, Matrix* X) const;
+
+		/**
+		 * Returns the determinant of A.
+		 */
+		double determinant(void) const;
+
+		/**
+		 * Computes the inverse of A. Returns false if A is singular.
+		 */
+		bool inverse(SquareMatrix* result) const;
+
+	private:
+		SquareMatrix        m_lu;       // unit lower triangle holds L, upper triangle U
+		std::vector<size_t> m_pivots;   // row i was swapped with row m_pivots[i] at step i
+		bool                m_singular;
+	};
+
+	/**
+	 * Cholesky decomposition of a symmetric positive definite matrix, A = LL^T. Only the lower triangle of A is read.
+	 * Blocked and right-looking, like LUDecomposition, and about twice as fast for the matrices it applies to.
+	 */
+	class CholeskyDecomposition
+	{
+	public:
+		CholeskyDecomposition(void);
+
+		/**
+		 * Factors A. Returns false if A isn't positive definite.
+		 */
+		bool factor(const SquareMatrix* A);
+
+		bool solve(const Vector* b, Vector* x) const;
+		bool solve(const Matrix* B, Matrix* X) const;
+		double determinant(void) const;
+		bool inverse(SquareMatrix* result) const;
+
+		/**
+		 * Returns L; everything above the diagonal is zero.
+		 */
+		const SquareMatrix& lower(void) const { return m_l; }
+
+	private:
+		SquareMatrix m_l;
+		bool         m_valid;
+	};
+
+	/**
+	 * Householder QR decomposition, A = QR, of an m x n matrix with m >= n. Blocks of reflectors are applied together
+	 * in compact WY form (I - V T V^T) as matrix products. solve gives the least squares solution when m > n.
+	 */
+	class QRDecomposition
+	{
+	public:
+		QRDecomposition(void);
+
+		/**
+		 * Factors A. Returns false if A has more columns than rows.
+		 */
+		bool factor(const Matrix* A);
+
+		/**
+		 * Finds the x minimizing |Ax - b|, which solves Ax = b when A is square. x has one element per column of A.
+		 * Returns false if the sizes don't match or R is singular.
+		 */
+		bool solve(const Vector* b, Vector* x) const;
+		bool solve(const Matrix* B, Matrix* X) const;
+
+		/**
+		 * Returns the determinant of A, which must be square.
+		 */
+		double determinant(void) const;
+		bool inverse(SquareMatrix* result) const;
+
+		/**
+		 * Computes the n x n upper triangular factor R.
+		 */
+		void r(Matrix* R) const;
+
+	private:
+		Matrix              m_qr;    // R on and above the diagonal, reflectors (with implicit leading ones) below
+		std::vector<double> m_tau;   // reflector scales, H = I - tau v v^T
+		bool                m_valid;
+
+		void applyQTranspose(Matrix* B) const;
+	};
+}
+
+#endif
@@ -20,12 +20,84 @@
 // SOFTWARE.
 
 #include "Distance.h"
-#include "Statistics.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <deque>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
+#include <vector>
+
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+#include <immintrin.h>
+#endif
 
 namespace LibMath
 {
+	constexpr double Distance::EARTH_RADIUS;
+	static const double DEG_TO_RAD = (double)(3.141592653589793238 / 180.0);
+	static const double HALF_PI = (double)1.5707963267948966192;
+
+	/// sin(x) for |x| <= pi/2, as x * P(x^2). Least squares fit on Chebyshev nodes; relative error < 5e-16.
+	static inline double fastSin(double x)
+	{
+		double z = x * x;
+		double p = (double)-7.37441787774224972e-13;
+		p = p * z + (double)1.60481709415005531e-10;
+		p = p * z + (double)-2.50518820357249186e-08;
+		p = p * z + (double)2.75573166105713672e-06;
+		p = p * z + (double)-1.98412698248748314e-04;
+		p = p * z + (double)8.33333333328280940e-03;
+		p = p * z + (double)-1.66666666666660745e-01;
+		p = p * z + (double)9.99999999999999889e-01;
+		return x * p;
+	}
+
+	/// cos of a latitude in degrees (|latitude| <= 90).
+	static inline double fastCosLat(double latDeg)
+	{
+		return fastSin(HALF_PI - fabs(latDeg * DEG_TO_RAD));
+	}
+
+	/// asin(x) for 0 <= x <= 1. Below 0.5 this is x + x^3 Q(x^2) (relative error < 1e-15); above that it uses
+	/// asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2)). Both sides are always computed so that there's no branch.
+	static inline double fastAsin(double x)
+	{
+		bool big = x > (double)0.5;
+		double z = big ? (double)0.5 * ((double)1.0 - x) : x * x;
+		double s = big ? sqrt(z) : x;
+		double q = (double)2.79840952415884754e-02;
+		q = q * z + (double)-6.96259784775531999e-03;
+		q = q * z + (double)1.55195349954790739e-02;
+		q = q * z + (double)1.02678461393395891e-02;
+		q = q * z + (double)1.41447979832627531e-02;
+		q = q * z + (double)1.73367705474946100e-02;
+		q = q * z + (double)2.23730381586334029e-02;
+		q = q * z + (double)3.03819164123193090e-02;
+		q = q * z + (double)4.46428575995088048e-02;
+		q = q * z + (double)7.49999999971070058e-02;
+		q = q * z + (double)1.66666666666669683e-01;
+		double result = s + s * z * q;
+		return big ? HALF_PI - (double)2.0 * result : result;
+	}
+
+	/// Same formula as haversineDistance, with the cos(latitude) terms supplied by the caller.
+	static inline double fastHaversine(double lat1, double lon1, double cosLat1, double lat2, double lon2, double cosLat2, double R)
+	{
+		double lonDelta = lon1 - lon2;
+		lonDelta = (lonDelta > (double)180.0) ? lonDelta - (double)360.0 : lonDelta;
+		lonDelta = (lonDelta < (double)-180.0) ? lonDelta + (double)360.0 : lonDelta;
+
+		double latH = fastSin((lat1 - lat2) * (DEG_TO_RAD * (double)0.5));
+		latH *= latH;
+		double lonH = fastSin(lonDelta * (DEG_TO_RAD * (double)0.5));
+		lonH *= lonH;
+
+		double h = latH + cosLat1 * cosLat2 * lonH;
+		h = (h > (double)1.0) ? (double)1.0 : h;
+		return (double)2.0 * fastAsin(sqrt(h)) * R;
+	}
+
 	double Distance::toRad(double deg)
 	{
 		const double pi = (double)(3.141592653589793238);
@@ -34,7 +106,7 @@ namespace LibMath
 
 	double Distance::haversineDistance(double loc1_lat, double loc1_lon, double loc1_alt, double loc2_lat, double loc2_lon, double loc2_alt)
 	{
-		double R = (double)6372797.560856; // radius of the earth in meters
+		double R = EARTH_RADIUS;
 		R += loc2_alt - loc1_alt;
 		
 		double latArc = toRad(loc1_lat - loc2_lat);
@@ -52,91 +124,441 @@ namespace LibMath
 		return rad * R;
 	}
 
+	double Distance::cosLatitude(double lat)
+	{
+		return fastCosLat(lat);
+	}
+
+	double Distance::haversineDistanceCosLat(double loc1_lat, double loc1_lon, double loc1_alt, double loc1_cosLat, double loc2_lat, double loc2_lon, double loc2_alt, double loc2_cosLat)
+	{
+		return fastHaversine(loc1_lat, loc1_lon, loc1_cosLat, loc2_lat, loc2_lon, loc2_cosLat, EARTH_RADIUS + loc2_alt - loc1_alt);
+	}
+
+	void Distance::haversineDistancesConsecutive(const double* lat, const double* lon, const double* alt, size_t numPoints, double* distances)
+	{
+		const size_t BLOCK_SIZE = 512;
+
+		// Work through the track in blocks, so the cached cos(latitude) values stay on the stack.
+		double cosLat[BLOCK_SIZE + 1];
+		for (size_t blockStart = 0; blockStart + 1 < numPoints; blockStart += BLOCK_SIZE)
+		{
+			size_t blockLen = numPoints - blockStart - 1;
+			if (blockLen > BLOCK_SIZE)
+				blockLen = BLOCK_SIZE;
+
+			const double* blockLat = lat + blockStart;
+			const double* blockLon = lon + blockStart;
+			for (size_t i = 0; i <= blockLen; ++i)
+				cosLat[i] = fastCosLat(blockLat[i]);
+
+			double* blockDistances = distances + blockStart;
+			if (alt)
+			{
+				const double* blockAlt = alt + blockStart;
+				for (size_t i = 0; i < blockLen; ++i)
+				{
+					double R = EARTH_RADIUS + blockAlt[i + 1] - blockAlt[i];
+					blockDistances[i] = fastHaversine(blockLat[i], blockLon[i], cosLat[i], blockLat[i + 1], blockLon[i + 1], cosLat[i + 1], R);
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < blockLen; ++i)
+					blockDistances[i] = fastHaversine(blockLat[i], blockLon[i], cosLat[i], blockLat[i + 1], blockLon[i + 1], cosLat[i + 1], EARTH_RADIUS);
+			}
+		}
+	}
+
+	void Distance::haversineDistancesFrom(double lat, double lon, double alt, const double* lats, const double* lons, const double* alts, size_t numPoints, double* distances)
+	{
+		double cosLat = fastCosLat(lat);
+
+		if (alts)
+		{
+			for (size_t i = 0; i < numPoints; ++i)
+				distances[i] = fastHaversine(lat, lon, cosLat, lats[i], lons[i], fastCosLat(lats[i]), EARTH_RADIUS + alts[i] - alt);
+		}
+		else
+		{
+			double R = EARTH_RADIUS - alt;
+			for (size_t i = 0; i < numPoints; ++i)
+				distances[i] = fastHaversine(lat, lon, cosLat, lats[i], lons[i], fastCosLat(lats[i]), R);
+		}
+	}
+
+	void Distance::haversineDistanceMatrix(const double* lat1, const double* lon1, const double* alt1, size_t numPoints1,
+		const double* lat2, const double* lon2, const double* alt2, size_t numPoints2, double* distances)
+	{
+		const size_t BLOCK_SIZE = 512;
+
+		// Go through the second set in column blocks, caching its cos(latitude) values, and sweep every row over each block.
+		double cosLat2[BLOCK_SIZE];
+		for (size_t blockStart = 0; blockStart < numPoints2; blockStart += BLOCK_SIZE)
+		{
+			size_t blockLen = numPoints2 - blockStart;
+			if (blockLen > BLOCK_SIZE)
+				blockLen = BLOCK_SIZE;
+
+			const double* blockLat = lat2 + blockStart;
+			const double* blockLon = lon2 + blockStart;
+			for (size_t j = 0; j < blockLen; ++j)
+				cosLat2[j] = fastCosLat(blockLat[j]);
+
+			for (size_t i = 0; i < numPoints1; ++i)
+			{
+				double rowLat = lat1[i];
+				double rowLon = lon1[i];
+				double rowCosLat = fastCosLat(rowLat);
+				double rowAlt = alt1 ? alt1[i] : (double)0.0;
+				double* row = distances + i * numPoints2 + blockStart;
+
+				if (alt2)
+				{
+					const double* blockAlt = alt2 + blockStart;
+					for (size_t j = 0; j < blockLen; ++j)
+						row[j] = fastHaversine(rowLat, rowLon, rowCosLat, blockLat[j], blockLon[j], cosLat2[j], EARTH_RADIUS + blockAlt[j] - rowAlt);
+				}
+				else
+				{
+					double R = EARTH_RADIUS - rowAlt;
+					for (size_t j = 0; j < blockLen; ++j)
+						row[j] = fastHaversine(rowLat, rowLon, rowCosLat, blockLat[j], blockLon[j], cosLat2[j], R);
+				}
+			}
+		}
+	}
+
 	size_t Distance::hammingDistance(const char* str1, const char* str2)
 	{
-		size_t len1 = strlen(str1);
+		size_t distance = 0;
 
-		// The strings must be the same length.
-		if (len1 != strlen(str2))
+		// One pass over both strings; they must be the same length.
+		size_t i = 0;
+		for (; str1[i] && str2[i]; ++i)
+		{
+			distance += (str1[i] != str2[i]);
+		}
+		if (str1[i] || str2[i])
 			return (size_t)-1;
-		
+		return distance;
+	}
+
+	/// Number of differing bits between two packed buffers. With AVX-512 VPOPCNTDQ this counts 8 (or, with AVX-512VL,
+	/// 4) words per instruction; otherwise it relies on the compiler's popcount, which is a single POPCNT instruction
+	/// when building for a CPU that has one (see LIBMATH_NATIVE).
+	static inline size_t popcountXor(const uint64_t* a, const uint64_t* b, size_t numWords)
+	{
 		size_t distance = 0;
-		
-		for (size_t i = 0; i < len1; ++i)
+		size_t i = 0;
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+		if (numWords >= 8)
+		{
+			__m512i sum = _mm512_setzero_si512();
+			for (; i + 8 <= numWords; i += 8)
+				sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i))));
+			distance = (size_t)_mm512_reduce_add_epi64(sum);
+		}
+#if defined(__AVX512VL__)
+		if (i + 4 <= numWords)
 		{
-			if (str1[i] != str2[i])
-				++distance;
+			__m256i counts = _mm256_popcnt_epi64(_mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i))));
+			__m128i pairs = _mm_add_epi64(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1));
+			distance += (size_t)(_mm_cvtsi128_si64(pairs) + _mm_extract_epi64(pairs, 1));
+			i += 4;
 		}
+#endif
+#endif
+		for (; i < numWords; ++i)
+			distance += (size_t)__builtin_popcountll(a[i] ^ b[i]);
 		return distance;
 	}
 
-	size_t Distance::levenshteinDistance(const char* str1, const char* str2)
+	size_t Distance::hammingDistance(const uint64_t* bits1, const uint64_t* bits2, size_t numWords)
 	{
-		size_t m = strlen(str1);
-		size_t n = strlen(str2);
-		
-		// Test for empty strings.
-		if (m == 0)
-			return n;
-		if (n == 0)
-			return m;
-		
-		// Temp vectors.
-		size_t vecSize = sizeof(size_t) * n;
-		size_t* v0 = (size_t*)malloc(vecSize);
-		if (!v0)
+		return popcountXor(bits1, bits2, numWords);
+	}
+
+	void Distance::hammingDistancesFrom(const uint64_t* bits, const uint64_t* fingerprints, size_t numFingerprints, size_t numWords, uint32_t* distances)
+	{
+		const size_t MIN_FINGERPRINTS_PER_THREAD = 65536;
+
+		Parallel::forRange(numFingerprints, MIN_FINGERPRINTS_PER_THREAD, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				distances[i] = (uint32_t)popcountXor(bits, fingerprints + i * numWords, numWords);
+		});
+	}
+
+	void Distance::hammingDistanceMatrix(const uint64_t* fingerprints1, size_t numFingerprints1,
+		const uint64_t* fingerprints2, size_t numFingerprints2, size_t numWords, uint32_t* distances)
+	{
+		const size_t BLOCK_BYTES = 16384; // a block of the second set stays in L1 while every row is swept over it
+		const size_t MIN_ROWS_PER_THREAD = 64;
+
+		size_t blockSize = BLOCK_BYTES / (numWords * sizeof(uint64_t) + 1) + 1;
+		Parallel::forRange(numFingerprints1, MIN_ROWS_PER_THREAD, [&](size_t rowBegin, size_t rowEnd) {
+			for (size_t blockStart = 0; blockStart < numFingerprints2; blockStart += blockSize)
+			{
+				size_t blockEnd = std::min(blockStart + blockSize, numFingerprints2);
+				for (size_t i = rowBegin; i < rowEnd; ++i)
+				{
+					const uint64_t* row = fingerprints1 + i * numWords;
+					uint32_t* rowDistances = distances + i * numFingerprints2;
+					for (size_t j = blockStart; j < blockEnd; ++j)
+						rowDistances[j] = (uint32_t)popcountXor(row, fingerprints2 + j * numWords, numWords);
+				}
+			}
+		});
+	}
+
+	/// Myers' bit-parallel edit distance (as reformulated by Hyyrö) between a pattern of 1 to 64 characters and a text.
+	/// Bit i of the vertical delta vectors says whether row i+1 of the current DP column is one more or one less than row i.
+	static size_t levenshteinSingleWord(const unsigned char* pattern, size_t m, const unsigned char* text, size_t n)
+	{
+		uint64_t peq[256];
+		memset(peq, 0, sizeof(peq));
+		for (size_t i = 0; i < m; ++i)
+			peq[pattern[i]] |= (uint64_t)1 << i;
+
+		const uint64_t last = (uint64_t)1 << (m - 1);
+		uint64_t vp = ~(uint64_t)0;
+		uint64_t vn = 0;
+		size_t score = m;
+
+		for (size_t j = 0; j < n; ++j)
 		{
-			return (size_t)-1;
+			uint64_t eq = peq[text[j]];
+			uint64_t xv = eq | vn;
+			uint64_t xh = (((eq & vp) + vp) ^ vp) | eq;
+			uint64_t ph = vn | ~(xh | vp);
+			uint64_t mh = vp & xh;
+			if (ph & last)
+				++score;
+			else if (mh & last)
+				--score;
+			ph = (ph << 1) | 1; // the top row of the DP matrix grows by one per column
+			mh <<= 1;
+			vp = mh | ~(xv | ph);
+			vn = ph & xv;
 		}
-		size_t* v1 = (size_t*)malloc(vecSize);
-		if (!v1)
+		return score;
+	}
+
+	/// The same algorithm over a pattern split into 64 bit blocks. Each block passes its horizontal delta
+	/// (-1, 0 or +1) at its last row down to the next block. 'peq' holds numWords words per character.
+	static size_t levenshteinMultiWord(const unsigned char* pattern, size_t m, const unsigned char* text, size_t n,
+		uint64_t* peq, uint64_t* vp, uint64_t* vn, size_t numWords)
+	{
+		memset(peq, 0, 256 * numWords * sizeof(uint64_t));
+		for (size_t i = 0; i < m; ++i)
+			peq[pattern[i] * numWords + i / 64] |= (uint64_t)1 << (i % 64);
+		for (size_t w = 0; w < numWords; ++w)
 		{
-			free((void*)v0);
-			return (size_t)-1;
+			vp[w] = ~(uint64_t)0;
+			vn[w] = 0;
 		}
-		size_t* tempV = (size_t*)malloc(vecSize);
-		if (!tempV)
+
+		const uint64_t high = (uint64_t)1 << 63;
+		const uint64_t last = (uint64_t)1 << ((m - 1) % 64);
+		size_t score = m;
+
+		for (size_t j = 0; j < n; ++j)
 		{
-			free((void*)v0);
-			free((void*)v1);
+			const uint64_t* eqs = peq + text[j] * numWords;
+			int hin = 1;
+			for (size_t w = 0; w < numWords; ++w)
+			{
+				uint64_t eq = eqs[w];
+				uint64_t xv = eq | vn[w];
+				if (hin < 0)
+					eq |= 1;
+				uint64_t xh = (((eq & vp[w]) + vp[w]) ^ vp[w]) | eq;
+				uint64_t ph = vn[w] | ~(xh | vp[w]);
+				uint64_t mh = vp[w] & xh;
+
+				uint64_t outBit = (w + 1 < numWords) ? high : last;
+				int hout = (ph & outBit) ? 1 : ((mh & outBit) ? -1 : 0);
+
+				ph <<= 1;
+				mh <<= 1;
+				if (hin < 0)
+					mh |= 1;
+				else if (hin > 0)
+					ph |= 1;
+				vp[w] = mh | ~(xv | ph);
+				vn[w] = ph & xv;
+				hin = hout;
+			}
+			score += hin;
+		}
+		return score;
+	}
+
+	size_t Distance::levenshteinDistance(const char* str1, const char* str2)
+	{
+		// Sanity check.
+		if ((str1 == NULL) || (str2 == NULL))
 			return (size_t)-1;
+
+		return levenshteinDistance(str1, strlen(str1), str2, strlen(str2));
+	}
+
+	size_t Distance::levenshteinDistance(const char* str1, size_t len1, const char* str2, size_t len2)
+	{
+		const size_t MAX_STACK_WORDS = 4; // patterns of up to 256 characters need no heap allocation
+
+		const unsigned char* a = (const unsigned char*)str1;
+		const unsigned char* b = (const unsigned char*)str2;
+
+		// A common prefix or suffix doesn't change the distance.
+		while ((len1 > 0) && (len2 > 0) && (*a == *b))
+		{
+			++a;
+			++b;
+			--len1;
+			--len2;
 		}
-		
-		for (size_t i = 0; i < n; ++i)
+		while ((len1 > 0) && (len2 > 0) && (a[len1 - 1] == b[len2 - 1]))
 		{
-			v0[i] = i;
+			--len1;
+			--len2;
 		}
-		for (size_t i = 0; i < m - 1; ++i)
+
+		// Use the shorter string as the pattern, so it takes as few words as possible.
+		if (len1 > len2)
 		{
-			v1[0] = i + 1;
-			
-			for (size_t j = 0; j < n - 1; ++j)
+			std::swap(a, b);
+			std::swap(len1, len2);
+		}
+		if (len1 == 0)
+			return len2;
+		if (len1 <= 64)
+			return levenshteinSingleWord(a, len1, b, len2);
+
+		size_t numWords = (len1 + 63) / 64;
+		if (numWords <= MAX_STACK_WORDS)
+		{
+			uint64_t peq[256 * MAX_STACK_WORDS];
+			uint64_t vp[MAX_STACK_WORDS];
+			uint64_t vn[MAX_STACK_WORDS];
+			return levenshteinMultiWord(a, len1, b, len2, peq, vp, vn, numWords);
+		}
+
+		std::vector<uint64_t> buffer((256 + 2) * numWords);
+		return levenshteinMultiWord(a, len1, b, len2, buffer.data(), buffer.data() + 256 * numWords, buffer.data() + 257 * numWords, numWords);
+	}
+
+	bool Distance::levenshteinWithin(const char* str1, const char* str2, size_t k)
+	{
+		// Sanity check.
+		if ((str1 == NULL) || (str2 == NULL))
+			return false;
+
+		return levenshteinWithin(str1, strlen(str1), str2, strlen(str2), k);
+	}
+
+	bool Distance::levenshteinWithin(const char* str1, size_t len1, const char* str2, size_t len2, size_t k)
+	{
+		const size_t MAX_BAND = 64; // wider bands are no cheaper than the bit-parallel distance
+
+		const unsigned char* a = (const unsigned char*)str1;
+		const unsigned char* b = (const unsigned char*)str2;
+
+		// Each edit changes the length by at most one.
+		if (len1 > len2)
+		{
+			std::swap(a, b);
+			std::swap(len1, len2);
+		}
+		size_t lenDiff = len2 - len1;
+		if (lenDiff > k)
+			return false;
+
+		while ((len1 > 0) && (*a == *b))
+		{
+			++a;
+			++b;
+			--len1;
+			--len2;
+		}
+		while ((len1 > 0) && (a[len1 - 1] == b[len2 - 1]))
+		{
+			--len1;
+			--len2;
+		}
+		if (len1 == 0)
+			return true;
+
+		// Each edit removes at most one surplus character from each side, so the larger of the two surpluses
+		// in the character histograms is a lower bound on the distance.
+		int counts[256];
+		memset(counts, 0, sizeof(counts));
+		for (size_t i = 0; i < len1; ++i)
+			++counts[a[i]];
+		for (size_t i = 0; i < len2; ++i)
+			--counts[b[i]];
+		size_t surplus1 = 0;
+		size_t surplus2 = 0;
+		for (size_t c = 0; c < 256; ++c)
+		{
+			if (counts[c] > 0)
+				surplus1 += counts[c];
+			else
+				surplus2 -= counts[c];
+		}
+		if (std::max(surplus1, surplus2) > k)
+			return false;
+
+		// Ukkonen's band: a path through the matrix that ends within k edits can't stray more than
+		// (k - lenDiff) / 2 diagonals below the main diagonal, or that far past the final one.
+		size_t slack = (k - lenDiff) / 2;
+		size_t width = lenDiff + 2 * slack + 1;
+		if (width > MAX_BAND)
+			return levenshteinDistance((const char*)a, len1, (const char*)b, len2) <= k;
+
+		// Cells are indexed by diagonal, t = j - i + slack, and saturate at k + 1.
+		const size_t tooFar = k + 1;
+		size_t rows[2][MAX_BAND + 1];
+		size_t* prev = rows[0];
+		size_t* cur = rows[1];
+		for (size_t t = 0; t <= width; ++t)
+			prev[t] = ((t >= slack) && (t < width) && (t - slack <= len2)) ? std::min(t - slack, tooFar) : tooFar;
+
+		for (size_t i = 1; i <= len1; ++i)
+		{
+			size_t rowMin = tooFar;
+			for (size_t t = 0; t < width; ++t)
 			{
-				size_t costs[3]; // deletion, insertion, and substitution costs (in that order)
-				costs[0] = v0[j + 1] + 1;
-				costs[1] = v1[j] + 1;
-				if (str1[i] == str2[j])
-					costs[2] = v0[j];
+				size_t j = i + t; // j + slack
+				if ((j < slack) || (j - slack > len2))
+				{
+					cur[t] = tooFar;
+					continue;
+				}
+				j -= slack;
+
+				size_t value;
+				if (j == 0)
+				{
+					value = i;
+				}
 				else
-					costs[2] = v0[j] + 1;
-				v1[j + 1] = Statistics::min(costs, 3);
+				{
+					value = prev[t] + ((a[i - 1] == b[j - 1]) ? 0 : 1);
+					value = std::min(value, prev[t + 1] + 1);
+					if (t > 0)
+						value = std::min(value, cur[t - 1] + 1);
+				}
+				cur[t] = std::min(value, tooFar);
+				rowMin = std::min(rowMin, cur[t]);
 			}
-			
-			// Copy v1 to v0.
-			memcpy(tempV, v0, vecSize);
-			memcpy(v0, v1, vecSize);
-			memcpy(v1, tempV, vecSize);
+			cur[width] = tooFar;
+
+			// Every path to the last cell passes through this row.
+			if (rowMin > k)
+				return false;
+			std::swap(prev, cur);
 		}
-		
-		// Save the final distance calculation, before freeing the vector.
-		size_t distance = v0[n - 1];
-		
-		// Clean up.
-		free((void*)v0);
-		free((void*)v1);
-		free((void*)tempV);
-		
-		return distance;
+		return prev[lenDiff + slack] <= k;
 	}
 
 	double Distance::euclidianDistance1D(double pt1, double pt2)
@@ -150,4 +572,519 @@ namespace LibMath
 		double tempY = pt2Y - pt1Y;
 		return sqrt((tempX * tempX) + (tempY * tempY));
 	}
+
+	/// Squared length of each of 'numPoints' points.
+	static void squaredNorms(const double* points, size_t numPoints, size_t dimensions, double* norms)
+	{
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			const double* point = points + i * dimensions;
+			double sum = (double)0.0;
+			for (size_t d = 0; d < dimensions; ++d)
+				sum += point[d] * point[d];
+			norms[i] = sum;
+		}
+	}
+
+	/// Copies points [begin, end) into groups of 8, each stored dimension-major and padded with zeros, so the
+	/// dot product kernel can read 8 columns with one contiguous load.
+	static void packColumns(const double* points, size_t begin, size_t end, size_t dimensions, double* packed)
+	{
+		for (size_t groupStart = begin; groupStart < end; groupStart += 8)
+		{
+			for (size_t d = 0; d < dimensions; ++d)
+			{
+				for (size_t jj = 0; jj < 8; ++jj)
+					packed[d * 8 + jj] = (groupStart + jj < end) ? points[(groupStart + jj) * dimensions + d] : (double)0.0;
+			}
+			packed += dimensions * 8;
+		}
+	}
+
+	/// Squared distances from rows [rowBegin, rowEnd) of 'points1' to 'numCols' packed columns, written to 'out' with
+	/// a row stride of 'outStride'. 'norms2' and each row of 'out' must have room for numCols rounded up to a multiple of 8. Uses |a-b|^2 = |a|^2 + |b|^2 - 2a.b, computing the dot products 4 rows by 8 columns
+	/// at a time in registers.
+	static void squaredDistanceTile(const double* points1, const double* norms1, size_t rowBegin, size_t rowEnd,
+		const double* packed, const double* norms2, size_t numCols, size_t dimensions, double* out, size_t outStride)
+	{
+		size_t numGroups = (numCols + 7) / 8;
+		for (size_t r0 = rowBegin; r0 < rowEnd; r0 += 4)
+		{
+			size_t numRows = std::min((size_t)4, rowEnd - r0);
+			const double* rows[4];
+			for (size_t i = 0; i < 4; ++i)
+				rows[i] = points1 + (r0 + std::min(i, numRows - 1)) * dimensions;
+
+			for (size_t group = 0; group < numGroups; ++group)
+			{
+				const double* p = packed + group * dimensions * 8;
+				double acc[4][8] = { { 0 } };
+				for (size_t d = 0; d < dimensions; ++d, p += 8)
+				{
+					double a0 = rows[0][d];
+					double a1 = rows[1][d];
+					double a2 = rows[2][d];
+					double a3 = rows[3][d];
+#pragma GCC unroll 8
+					for (size_t jj = 0; jj < 8; ++jj)
+					{
+						acc[0][jj] += a0 * p[jj];
+						acc[1][jj] += a1 * p[jj];
+						acc[2][jj] += a2 * p[jj];
+						acc[3][jj] += a3 * p[jj];
+					}
+				}
+
+				// Padding columns are computed too; 'out' and 'norms2' have room for them.
+				for (size_t i = 0; i < numRows; ++i)
+				{
+					double* row = out + (r0 - rowBegin + i) * outStride + group * 8;
+					double norm = norms1[r0 + i];
+					for (size_t jj = 0; jj < 8; ++jj)
+						row[jj] = std::max(norm + norms2[group * 8 + jj] - (double)2.0 * acc[i][jj], (double)0.0);
+				}
+			}
+		}
+	}
+
+	/// Sweeps rows [rowBegin, rowEnd) of 'points1' over columns [colBegin, colEnd) of 'points2', a tile at a time,
+	/// calling fn(row, colStart, numCols, squaredDistances) with each row's slice of each tile.
+	template <typename Fn>
+	static void sweepRows(const double* points1, const double* norms1, size_t rowBegin, size_t rowEnd,
+		const double* points2, const double* norms2, size_t colBegin, size_t colEnd, size_t dimensions, Fn& fn)
+	{
+		const size_t ROW_TILE = 32;
+		const size_t PACKED_BYTES = 32768; // keep a packed column tile in L1
+
+		size_t colTile = PACKED_BYTES / (dimensions * sizeof(double));
+		colTile = std::max((size_t)16, std::min((size_t)512, colTile & ~(size_t)7));
+		std::vector<double> packed(colTile * dimensions);
+		std::vector<double> packedNorms(colTile);
+		std::vector<double> tile(ROW_TILE * colTile);
+
+		for (size_t colStart = colBegin; colStart < colEnd; colStart += colTile)
+		{
+			size_t numCols = std::min(colTile, colEnd - colStart);
+			packColumns(points2, colStart, colStart + numCols, dimensions, packed.data());
+			std::fill(std::copy(norms2 + colStart, norms2 + colStart + numCols, packedNorms.begin()), packedNorms.end(), (double)0.0);
+			for (size_t rowStart = rowBegin; rowStart < rowEnd; rowStart += ROW_TILE)
+			{
+				size_t rowStop = std::min(rowStart + ROW_TILE, rowEnd);
+				squaredDistanceTile(points1, norms1, rowStart, rowStop, packed.data(), packedNorms.data(), numCols, dimensions, tile.data(), colTile);
+				for (size_t row = rowStart; row < rowStop; ++row)
+					fn(row, colStart, numCols, tile.data() + (row - rowStart) * colTile);
+			}
+		}
+	}
+
+	void Distance::euclidianDistanceMatrix(const double* points1, size_t numPoints1, const double* points2, size_t numPoints2,
+		size_t dimensions, double* distances)
+	{
+		const size_t MIN_ROWS_PER_THREAD = 32;
+
+		// Sanity check.
+		if ((numPoints1 == 0) || (numPoints2 == 0) || (dimensions == 0))
+			return;
+
+		std::vector<double> norms1(numPoints1);
+		std::vector<double> norms2(numPoints2);
+		squaredNorms(points1, numPoints1, dimensions, norms1.data());
+		squaredNorms(points2, numPoints2, dimensions, norms2.data());
+
+		Parallel::forRange(numPoints1, MIN_ROWS_PER_THREAD, [&](size_t rowBegin, size_t rowEnd) {
+			auto store = [&](size_t row, size_t colStart, size_t numCols, const double* squared) {
+				double* out = distances + row * numPoints2 + colStart;
+				for (size_t j = 0; j < numCols; ++j)
+					out[j] = sqrt(squared[j]);
+			};
+			sweepRows(points1, norms1.data(), rowBegin, rowEnd, points2, norms2.data(), 0, numPoints2, dimensions, store);
+		});
+	}
+
+	void Distance::euclidianDistancesCondensed(const double* points, size_t numPoints, size_t dimensions, double* distances)
+	{
+		const size_t ROWS_PER_TASK = 16;
+
+		// Sanity check.
+		if ((numPoints < 2) || (dimensions == 0))
+			return;
+
+		std::vector<double> norms(numPoints);
+		squaredNorms(points, numPoints, dimensions, norms.data());
+
+		// Rows near the top of the triangle have the most columns, so each task takes one block of rows from the top
+		// and the matching block from the bottom.
+		size_t numBlocks = (numPoints + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+		Parallel::forRange((numBlocks + 1) / 2, 1, [&](size_t taskBegin, size_t taskEnd) {
+			auto store = [&](size_t row, size_t colStart, size_t numCols, const double* squared) {
+				// Row i of the condensed matrix holds columns i+1 .. n-1. (The unsigned offset wraps for row 0, and wraps back when j is added.)
+				size_t offset = row * numPoints - row * (row + 1) / 2 - row - 1;
+				for (size_t j = std::max(colStart, row + 1); j < colStart + numCols; ++j)
+					distances[offset + j] = sqrt(squared[j - colStart]);
+			};
+			for (size_t task = taskBegin; task < taskEnd; ++task)
+			{
+				size_t blocks[2] = { task, numBlocks - 1 - task };
+				for (size_t i = 0; i < ((blocks[0] == blocks[1]) ? 1 : 2); ++i)
+				{
+					size_t rowBegin = blocks[i] * ROWS_PER_TASK;
+					size_t rowEnd = std::min(rowBegin + ROWS_PER_TASK, numPoints);
+					sweepRows(points, norms.data(), rowBegin, rowEnd, points, norms.data(), rowBegin + 1, numPoints, dimensions, store);
+				}
+			}
+		});
+	}
+
+	/// Shared by both nearest neighbor forms; 'excludeSelf' skips column i for row i.
+	static void nearestNeighbors(const double* queries, size_t numQueries, const double* points, size_t numPoints,
+		size_t dimensions, size_t k, bool excludeSelf, size_t* indices, double* distances)
+	{
+		const size_t ROWS_PER_TASK = 32;
+
+		// Sanity check.
+		if ((k == 0) || (numQueries == 0) || (dimensions == 0))
+			return;
+
+		std::vector<double> queryNorms(numQueries);
+		std::vector<double> pointNorms(numPoints);
+		squaredNorms(queries, numQueries, dimensions, queryNorms.data());
+		squaredNorms(points, numPoints, dimensions, pointNorms.data());
+
+		// Keep a max heap of the k closest columns seen so far for each row, so the full row is never stored.
+		Parallel::forRange(numQueries, ROWS_PER_TASK, [&](size_t taskBegin, size_t taskEnd) {
+			std::vector<std::pair<double, size_t> > heaps(ROWS_PER_TASK * k);
+			std::vector<size_t> heapSizes(ROWS_PER_TASK);
+			size_t rowBegin = 0;
+			auto offer = [&](size_t row, size_t colStart, size_t numCols, const double* squared) {
+				std::pair<double, size_t>* heap = heaps.data() + (row - rowBegin) * k;
+				size_t& heapSize = heapSizes[row - rowBegin];
+				for (size_t j = 0; j < numCols; ++j)
+				{
+					size_t col = colStart + j;
+					if (excludeSelf && (col == row))
+						continue;
+					if (heapSize < k)
+					{
+						heap[heapSize++] = std::make_pair(squared[j], col);
+						std::push_heap(heap, heap + heapSize);
+					}
+					else if (squared[j] < heap[0].first)
+					{
+						std::pop_heap(heap, heap + k);
+						heap[k - 1] = std::make_pair(squared[j], col);
+						std::push_heap(heap, heap + k);
+					}
+				}
+			};
+
+			for (rowBegin = taskBegin; rowBegin < taskEnd; rowBegin += ROWS_PER_TASK)
+			{
+				size_t rowEnd = std::min(rowBegin + ROWS_PER_TASK, taskEnd);
+				std::fill(heapSizes.begin(), heapSizes.end(), 0);
+				sweepRows(queries, queryNorms.data(), rowBegin, rowEnd, points, pointNorms.data(), 0, numPoints, dimensions, offer);
+
+				for (size_t row = rowBegin; row < rowEnd; ++row)
+				{
+					std::pair<double, size_t>* heap = heaps.data() + (row - rowBegin) * k;
+					size_t heapSize = heapSizes[row - rowBegin];
+					std::sort_heap(heap, heap + heapSize);
+					for (size_t i = 0; i < k; ++i)
+					{
+						indices[row * k + i] = (i < heapSize) ? heap[i].second : (size_t)-1;
+						if (distances)
+							distances[row * k + i] = (i < heapSize) ? sqrt(heap[i].first) : HUGE_VAL;
+					}
+				}
+			}
+		});
+	}
+
+	void Distance::euclidianNearestNeighbors(const double* queries, size_t numQueries, const double* points, size_t numPoints,
+		size_t dimensions, size_t k, size_t* indices, double* distances)
+	{
+		nearestNeighbors(queries, numQueries, points, numPoints, dimensions, k, false, indices, distances);
+	}
+
+	void Distance::euclidianNearestNeighbors(const double* points, size_t numPoints, size_t dimensions, size_t k, size_t* indices, double* distances)
+	{
+		nearestNeighbors(points, numPoints, points, numPoints, dimensions, k, true, indices, distances);
+	}
+
+	/// Squared difference, the point to point cost used by all of the DTW functions.
+	static inline double dtwCost(double a, double b)
+	{
+		return (a - b) * (a - b);
+	}
+
+	/// DTW over a Sakoe-Chiba band of half width 'window', using two rows of 2 * window + 1 cells indexed by j - i + window.
+	/// 'series1' is normalized on the fly as (x - mean) / stdDev. Gives up, returning the partial cost, once the cheapest cell
+	/// in row i plus remainingBound[i + window + 1] (a lower bound on the cost of the rows still to come, or NULL) reaches
+	/// 'abandonAt'. Costs are squared.
+	static double dtwBanded(const double* series1, size_t len1, double mean, double stdDev, const double* series2, size_t len2,
+		size_t window, const double* remainingBound, double abandonAt, double* row, double* prevRow)
+	{
+		size_t width = 2 * window + 1;
+		for (size_t k = 0; k < width; ++k)
+			prevRow[k] = HUGE_VAL;
+
+		for (size_t i = 0; i < len1; ++i)
+		{
+			double x = (series1[i] - mean) / stdDev;
+			double rowMin = HUGE_VAL;
+			size_t jBegin = (i > window) ? i - window : 0;
+			size_t jEnd = std::min(i + window + 1, len2);
+			for (size_t k = 0; k < width; ++k)
+				row[k] = HUGE_VAL;
+
+			for (size_t j = jBegin; j < jEnd; ++j)
+			{
+				size_t k = j + window - i;
+				double best;
+				if ((i == 0) && (j == 0))
+				{
+					best = (double)0.0;
+				}
+				else
+				{
+					best = prevRow[k];                               // (i - 1, j - 1)
+					if (k + 1 < width)
+						best = std::min(best, prevRow[k + 1]);       // (i - 1, j)
+					if (k > 0)
+						best = std::min(best, row[k - 1]);           // (i, j - 1)
+				}
+				row[k] = best + dtwCost(x, series2[j]);
+				rowMin = std::min(rowMin, row[k]);
+			}
+
+			if (remainingBound && (i + window + 1 < len1))
+			{
+				if (rowMin + remainingBound[i + window + 1] >= abandonAt)
+					return rowMin + remainingBound[i + window + 1];
+			}
+			else if (rowMin >= abandonAt)
+			{
+				return rowMin;
+			}
+			std::swap(row, prevRow);
+		}
+		return prevRow[len2 - 1 + window - (len1 - 1)];
+	}
+
+	double Distance::dtwDistance(const double* series1, size_t len1, const double* series2, size_t len2, size_t window, double abandonAbove)
+	{
+		// Sanity check.
+		if ((len1 == 0) || (len2 == 0))
+			return HUGE_VAL;
+
+		// The band has to reach the far corner.
+		window = std::max(window, (len1 > len2) ? len1 - len2 : len2 - len1);
+		window = std::min(window, std::max(len1, len2));
+
+		std::vector<double> rows(2 * (2 * window + 1));
+		double abandonAt = (abandonAbove < HUGE_VAL) ? abandonAbove * abandonAbove : HUGE_VAL;
+		double cost = dtwBanded(series1, len1, (double)0.0, (double)1.0, series2, len2, window, NULL, abandonAt,
+			rows.data(), rows.data() + 2 * window + 1);
+		return (cost >= abandonAt) ? HUGE_VAL : sqrt(cost);
+	}
+
+	void Distance::dtwEnvelope(const double* series, size_t len, size_t window, double* upper, double* lower)
+	{
+		// Lemire's streaming min/max: each deque holds the indices that can still be the max (or min) of a later window,
+		// with their values in decreasing (or increasing) order.
+		std::deque<size_t> maxIndices;
+		std::deque<size_t> minIndices;
+		for (size_t i = 0; i < len + window; ++i)
+		{
+			if (i < len)
+			{
+				while (!maxIndices.empty() && (series[maxIndices.back()] <= series[i]))
+					maxIndices.pop_back();
+				maxIndices.push_back(i);
+				while (!minIndices.empty() && (series[minIndices.back()] >= series[i]))
+					minIndices.pop_back();
+				minIndices.push_back(i);
+			}
+			if (i >= window)
+			{
+				size_t center = i - window;
+				while (maxIndices.front() + window < center)
+					maxIndices.pop_front();
+				while (minIndices.front() + window < center)
+					minIndices.pop_front();
+				upper[center] = series[maxIndices.front()];
+				lower[center] = series[minIndices.front()];
+			}
+		}
+	}
+
+	double Distance::lbKim(const double* series1, const double* series2, size_t len)
+	{
+		// Sanity check.
+		if (len == 0)
+			return (double)0.0;
+
+		// Any warping path starts at (0, 0) and ends at (len - 1, len - 1).
+		double bound = dtwCost(series1[0], series2[0]);
+		if (len > 1)
+			bound += dtwCost(series1[len - 1], series2[len - 1]);
+
+		// With enough points to keep the two ends apart, it also passes through one of the cells next to each corner.
+		if (len >= 4)
+		{
+			bound += std::min(std::min(dtwCost(series1[1], series2[0]), dtwCost(series1[0], series2[1])), dtwCost(series1[1], series2[1]));
+			bound += std::min(std::min(dtwCost(series1[len - 2], series2[len - 1]), dtwCost(series1[len - 1], series2[len - 2])),
+				dtwCost(series1[len - 2], series2[len - 2]));
+		}
+		return sqrt(bound);
+	}
+
+	double Distance::lbKeogh(const double* series, const double* upper, const double* lower, size_t len)
+	{
+		double bound = (double)0.0;
+		for (size_t i = 0; i < len; ++i)
+		{
+			if (series[i] > upper[i])
+				bound += dtwCost(series[i], upper[i]);
+			else if (series[i] < lower[i])
+				bound += dtwCost(series[i], lower[i]);
+		}
+		return sqrt(bound);
+	}
+
+	size_t Distance::dtwSubsequenceSearch(const double* signal, size_t signalLen, const double* query, size_t queryLen, size_t window,
+		bool zNormalize, double* distance)
+	{
+		const size_t RESUM_INTERVAL = 65536; // recompute the running sums now and then, so rounding can't build up
+		const double MIN_STD_DEV = (double)1e-12;
+
+		if (distance)
+			*distance = HUGE_VAL;
+
+		// Sanity check.
+		if ((queryLen == 0) || (signalLen < queryLen))
+			return (size_t)-1;
+
+		size_t m = queryLen;
+		window = std::min(window, m - 1);
+
+		// Normalize the query, and visit its points from the largest magnitude down, since those tend to
+		// push the lower bounds over the best so far soonest.
+		std::vector<double> q(query, query + m);
+		if (zNormalize)
+		{
+			double sum = (double)0.0;
+			double sumSquares = (double)0.0;
+			for (size_t i = 0; i < m; ++i)
+			{
+				sum += q[i];
+				sumSquares += q[i] * q[i];
+			}
+			double mean = sum / m;
+			double stdDev = sqrt(std::max(sumSquares / m - mean * mean, (double)0.0));
+			if (stdDev < MIN_STD_DEV)
+				stdDev = (double)1.0;
+			for (size_t i = 0; i < m; ++i)
+				q[i] = (q[i] - mean) / stdDev;
+		}
+		std::vector<size_t> order(m);
+		for (size_t i = 0; i < m; ++i)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&q](size_t a, size_t b) { return fabs(q[a]) > fabs(q[b]); });
+
+		// Envelopes of the query and of the raw signal, for LB_Keogh in both directions.
+		std::vector<double> queryUpper(m), queryLower(m);
+		dtwEnvelope(q.data(), m, window, queryUpper.data(), queryLower.data());
+		std::vector<double> signalUpper(signalLen), signalLower(signalLen);
+		dtwEnvelope(signal, signalLen, window, signalUpper.data(), signalLower.data());
+
+		std::vector<double> candidate(m);
+		std::vector<double> bound1(m), bound2(m), remainingBound(m + 1);
+		std::vector<double> rows(2 * (2 * window + 1));
+		double best = HUGE_VAL;
+		size_t bestStart = (size_t)-1;
+		double sum = (double)0.0;
+		double sumSquares = (double)0.0;
+
+		for (size_t start = 0; start + m <= signalLen; ++start)
+		{
+			const double* c = signal + start;
+			double mean = (double)0.0;
+			double stdDev = (double)1.0;
+			if (zNormalize)
+			{
+				if (start % RESUM_INTERVAL == 0)
+				{
+					sum = (double)0.0;
+					sumSquares = (double)0.0;
+					for (size_t i = 0; i < m; ++i)
+					{
+						sum += c[i];
+						sumSquares += c[i] * c[i];
+					}
+				}
+				else
+				{
+					sum += c[m - 1] - c[-1];
+					sumSquares += c[m - 1] * c[m - 1] - c[-1] * c[-1];
+				}
+				mean = sum / m;
+				stdDev = sqrt(std::max(sumSquares / m - mean * mean, (double)0.0));
+				if (stdDev < MIN_STD_DEV)
+					stdDev = (double)1.0;
+			}
+
+			// LB_Kim, on the normalized ends of the candidate.
+			for (size_t i = 0; i < std::min(m, (size_t)2); ++i)
+			{
+				candidate[i] = (c[i] - mean) / stdDev;
+				candidate[m - 1 - i] = (c[m - 1 - i] - mean) / stdDev;
+			}
+			double lb = lbKim(candidate.data(), q.data(), m);
+			if (lb * lb >= best)
+				continue;
+
+			// LB_Keogh of the candidate against the query's envelope.
+			double lbQuery = (double)0.0;
+			for (size_t i = 0; (i < m) && (lbQuery < best); ++i)
+			{
+				size_t index = order[i];
+				double x = (c[index] - mean) / stdDev;
+				double d = (x > queryUpper[index]) ? dtwCost(x, queryUpper[index]) : ((x < queryLower[index]) ? dtwCost(x, queryLower[index]) : (double)0.0);
+				bound1[index] = d;
+				lbQuery += d;
+			}
+			if (lbQuery >= best)
+				continue;
+
+			// LB_Keogh of the query against the candidate's envelope.
+			double lbCandidate = (double)0.0;
+			for (size_t i = 0; (i < m) && (lbCandidate < best); ++i)
+			{
+				size_t index = order[i];
+				double upper = (signalUpper[start + index] - mean) / stdDev;
+				double lower = (signalLower[start + index] - mean) / stdDev;
+				double d = (q[index] > upper) ? dtwCost(q[index], upper) : ((q[index] < lower) ? dtwCost(q[index], lower) : (double)0.0);
+				bound2[index] = d;
+				lbCandidate += d;
+			}
+			if (lbCandidate >= best)
+				continue;
+
+			// Run the DTW, abandoning it when the rows so far plus the tighter bound on the rest reach the best so far.
+			const std::vector<double>& perPoint = (lbQuery > lbCandidate) ? bound1 : bound2;
+			remainingBound[m] = (double)0.0;
+			for (size_t i = m; i-- > 0;)
+				remainingBound[i] = remainingBound[i + 1] + perPoint[i];
+			double cost = dtwBanded(c, m, mean, stdDev, q.data(), m, window, remainingBound.data(), best, rows.data(), rows.data() + 2 * window + 1);
+			if (cost < best)
+			{
+				best = cost;
+				bestStart = start;
+			}
+		}
+
+		if (distance)
+			*distance = sqrt(best);
+		return bestStart;
+	}
 }
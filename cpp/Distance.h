@@ -24,6 +24,8 @@
 #ifndef _DISTANCE_
 #define _DISTANCE_
 
+#include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 namespace LibMath
@@ -31,21 +33,102 @@ namespace LibMath
 	class Distance
 	{
 	public:
+		/**
+		 * Radius of the Earth, in meters, used by the haversine functions below.
+		 */
+		static constexpr double EARTH_RADIUS = 6372797.560856;
+
+		/**
+		 * Converts a latitude and longitude, in degrees, to the unit vector from the Earth's center through that point.
+		 */
+		static void toUnitVector(double lat, double lon, double* xyz)
+		{
+			const double degToRad = (double)(3.141592653589793238 / 180.0);
+			double latRad = lat * degToRad;
+			double lonRad = lon * degToRad;
+			xyz[0] = cos(latRad) * cos(lonRad);
+			xyz[1] = cos(latRad) * sin(lonRad);
+			xyz[2] = sin(latRad);
+		}
+
 		/**
 		 * Computes the Haversine distance between two points on Earth's surface.
 		 */
 		static double haversineDistance(double loc1_lat, double loc1_lon, double loc1_alt, double loc2_lat, double loc2_lon, double loc2_alt);
 
+		/**
+		 * Returns the cos(latitude) term used by haversineDistanceCosLat, for a latitude in degrees.
+		 */
+		static double cosLatitude(double lat);
+
+		/**
+		 * Same as haversineDistance, but with each point's cos(latitude) (from cosLatitude) supplied by the caller, so that
+		 * it can be computed once per point rather than once per pair. Same accuracy as the batch forms below.
+		 */
+		static double haversineDistanceCosLat(double loc1_lat, double loc1_lon, double loc1_alt, double loc1_cosLat, double loc2_lat, double loc2_lon, double loc2_alt, double loc2_cosLat);
+
+		/**
+		 * Computes the Haversine distance between each pair of consecutive points, writing numPoints - 1 values to 'distances'.
+		 *
+		 * This, and the other batch forms below, take coordinates as separate latitude, longitude (degrees, longitude in
+		 * [-180, 180]) and altitude (meters) arrays. Altitude arrays may be NULL, meaning zero altitude. Each point's
+		 * cos(latitude) is computed once, and sin and asin are replaced by polynomial approximations so that the loops
+		 * vectorize. Results are within 1e-12 (relative) of haversineDistance.
+		 */
+		static void haversineDistancesConsecutive(const double* lat, const double* lon, const double* alt, size_t numPoints, double* distances);
+
+		/**
+		 * Computes the distance from one point to each of the 'numPoints' points, writing numPoints values to 'distances'.
+		 */
+		static void haversineDistancesFrom(double lat, double lon, double alt, const double* lats, const double* lons, const double* alts, size_t numPoints, double* distances);
+
+		/**
+		 * Computes the distance from every point in the first set to every point in the second,
+		 * writing numPoints1 x numPoints2 values, row-major, to 'distances'.
+		 */
+		static void haversineDistanceMatrix(const double* lat1, const double* lon1, const double* alt1, size_t numPoints1,
+			const double* lat2, const double* lon2, const double* alt2, size_t numPoints2, double* distances);
+
 		/**
 		 * Computes the Hamming distance of the strings.
 		 */
 		static size_t hammingDistance(const char* str1, const char* str2);
+
+		/**
+		 * Computes the Hamming distance of two bit strings packed into 'numWords' 64 bit words each.
+		 */
+		static size_t hammingDistance(const uint64_t* bits1, const uint64_t* bits2, size_t numWords);
+
+		/**
+		 * Computes the Hamming distance from one packed bit string to each of 'numFingerprints' others, stored one after
+		 * another, writing numFingerprints values to 'distances'.
+		 */
+		static void hammingDistancesFrom(const uint64_t* bits, const uint64_t* fingerprints, size_t numFingerprints, size_t numWords, uint32_t* distances);
+
+		/**
+		 * Computes the Hamming distance from every packed bit string in the first set to every one in the second,
+		 * writing numFingerprints1 x numFingerprints2 values, row-major, to 'distances'.
+		 */
+		static void hammingDistanceMatrix(const uint64_t* fingerprints1, size_t numFingerprints1,
+			const uint64_t* fingerprints2, size_t numFingerprints2, size_t numWords, uint32_t* distances);
 		
 		/**
 		 * Computes the Levenshtein distance of str2 relative to str1.
 		 */
 		static size_t levenshteinDistance(const char* str1, const char* str2);
 
+		/**
+		 * Computes the Levenshtein distance of two strings of the given lengths, which need not be NULL terminated.
+		 */
+		static size_t levenshteinDistance(const char* str1, size_t len1, const char* str2, size_t len2);
+
+		/**
+		 * Returns TRUE if the Levenshtein distance of the strings is at most k. Much cheaper than computing the
+		 * distance when k is small, and cheaper still when the strings clearly differ.
+		 */
+		static bool levenshteinWithin(const char* str1, const char* str2, size_t k);
+		static bool levenshteinWithin(const char* str1, size_t len1, const char* str2, size_t len2, size_t k);
+
 		/**
 		 * Computes the Euclidian distance between two points in a 1D space.
 		 */
@@ -56,6 +139,68 @@ namespace LibMath
 		 */
 		static double euclidianDistance2D(double pt1X, double pt1Y, double pt2X, double pt2Y);
 
+		/**
+		 * Computes the Euclidian distance from every point in the first set to every point in the second, writing
+		 * numPoints1 x numPoints2 values, row-major, to 'distances'. Points are stored one after another, 'dimensions'
+		 * values each. Uses the |a|^2 + |b|^2 - 2a.b form, so distances much smaller than the points' norms lose precision.
+		 * When 'dimensions' is zero, this and the functions below write nothing.
+		 */
+		static void euclidianDistanceMatrix(const double* points1, size_t numPoints1, const double* points2, size_t numPoints2,
+			size_t dimensions, double* distances);
+
+		/**
+		 * Computes the Euclidian distance between every pair of points, writing the upper triangle of the distance
+		 * matrix (numPoints * (numPoints - 1) / 2 values, row by row) to 'distances'.
+		 */
+		static void euclidianDistancesCondensed(const double* points, size_t numPoints, size_t dimensions, double* distances);
+
+		/**
+		 * Finds the k closest points to each query, closest first, without storing the full distance matrix. Writes
+		 * numQueries x k indices to 'indices' and, if not NULL, distances to 'distances'. Rows with fewer than k
+		 * points are padded with an index of (size_t)-1 and a distance of HUGE_VAL.
+		 */
+		static void euclidianNearestNeighbors(const double* queries, size_t numQueries, const double* points, size_t numPoints,
+			size_t dimensions, size_t k, size_t* indices, double* distances);
+
+		/**
+		 * As above, with the points as their own queries, leaving each point out of its own neighbors.
+		 */
+		static void euclidianNearestNeighbors(const double* points, size_t numPoints, size_t dimensions, size_t k, size_t* indices, double* distances);
+
+		/**
+		 * Computes the dynamic time warping distance between two series, with warping limited to a Sakoe-Chiba band of
+		 * 'window' points either side of the diagonal (widened, if need be, to the difference in length). Point costs are
+		 * squared differences and the result is the square root of the total, so with a window of zero it matches the
+		 * Euclidian distance. Returns HUGE_VAL as soon as the distance is known to exceed 'abandonAbove'. Uses O(window) memory.
+		 */
+		static double dtwDistance(const double* series1, size_t len1, const double* series2, size_t len2, size_t window, double abandonAbove = HUGE_VAL);
+
+		/**
+		 * Computes the upper and lower envelope of a series: the max and min of the points within 'window' of each point.
+		 */
+		static void dtwEnvelope(const double* series, size_t len, size_t window, double* upper, double* lower);
+
+		/**
+		 * LB_Kim lower bound on the DTW distance between two series of the same length, from the points at either end.
+		 */
+		static double lbKim(const double* series1, const double* series2, size_t len);
+
+		/**
+		 * LB_Keogh lower bound on the DTW distance between 'series' and another series of the same length, given that
+		 * series' envelope (see dtwEnvelope) for the same window.
+		 */
+		static double lbKeogh(const double* series, const double* upper, const double* lower, size_t len);
+
+		/**
+		 * Finds the subsequence of 'signal' closest to 'query' under DTW, UCR suite style: candidates are pruned with
+		 * LB_Kim and LB_Keogh (both ways) and the DTW is abandoned early, so most of the signal is never fully compared.
+		 * With 'zNormalize', the query and every candidate are compared after normalizing them to zero mean and unit
+		 * variance. Returns the start of the best match, and its distance in 'distance' if not NULL, or (size_t)-1 if the
+		 * signal is shorter than the query.
+		 */
+		static size_t dtwSubsequenceSearch(const double* signal, size_t signalLen, const double* query, size_t queryLen, size_t window,
+			bool zNormalize, double* distance);
+
 	private:
 		static double toRad(double deg);
 	};
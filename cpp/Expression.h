@@ -0,0 +1,295 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _EXPRESSION_
+#define _EXPRESSION_
+
+#include <math.h>
+#include <stdlib.h>
+#include <type_traits>
+
+namespace LibMath
+{
+	class Matrix;
+	class Vector;
+
+	/**
+	 * Lazy elementwise arithmetic on Vector and Matrix objects. Operators build a tree of small expression objects
+	 * instead of computing anything; assigning the tree to a Vector or Matrix evaluates every element in a single loop,
+	 * so C = a * A - B + s reads A and B once, writes C once, and needs no temporaries.
+	 *
+	 * Matrix and Vector operands are referenced, not copied, and must outlive the expression. Because every element
+	 * is computed from the same element of each operand, the target may also appear on the right hand side.
+	 */
+	class ExpressionBase
+	{
+	};
+
+	template <typename E>
+	class Expression : public ExpressionBase
+	{
+	public:
+		const E& derived(void) const { return static_cast<const E&>(*this); }
+	};
+
+	/**
+	 * Leaf nodes. 'rank' is 0 for scalars, 1 for vectors and 2 for matrices. width and height follow Matrix (a vector
+	 * of n elements is n x 1), and are zero for scalars, which fit any shape.
+	 */
+	class ScalarOperand : public Expression<ScalarOperand>
+	{
+	public:
+		static const int rank = 0;
+
+		explicit ScalarOperand(double value) : m_value(value) {}
+
+		template <typename... Index>
+		double operator()(Index...) const { return m_value; }
+		bool conforms(size_t, size_t) const { return true; }
+		size_t width(void) const { return 0; }
+		size_t height(void) const { return 0; }
+
+	private:
+		double m_value;
+	};
+
+	class VectorOperand : public Expression<VectorOperand>
+	{
+	public:
+		static const int rank = 1;
+
+		VectorOperand(const double* data, size_t size) : m_data(data), m_size(size) {}
+
+		double operator()(size_t i) const { return m_data[i]; }
+		bool conforms(size_t size, size_t) const { return size == m_size; }
+		size_t width(void) const { return m_size; }
+		size_t height(void) const { return 1; }
+
+	private:
+		const double* m_data;
+		size_t m_size;
+	};
+
+	class MatrixOperand : public Expression<MatrixOperand>
+	{
+	public:
+		static const int rank = 2;
+
+		MatrixOperand(const double* data, size_t stride, size_t w, size_t h) : m_data(data), m_stride(stride), m_w(w), m_h(h) {}
+
+		double operator()(size_t i, size_t j) const { return m_data[i * m_stride + j]; }
+		bool conforms(size_t w, size_t h) const { return (w == m_w) && (h == m_h); }
+		size_t width(void) const { return m_w; }
+		size_t height(void) const { return m_h; }
+
+	private:
+		const double* m_data;
+		size_t m_stride;
+		size_t m_w;
+		size_t m_h;
+	};
+
+	/**
+	 * Interior nodes.
+	 */
+	template <typename Op, typename L, typename R>
+	class BinaryExpression : public Expression<BinaryExpression<Op, L, R> >
+	{
+	public:
+		static const int rank = (L::rank > R::rank) ? L::rank : R::rank;
+		static_assert((L::rank == 0) || (R::rank == 0) || (L::rank == R::rank), "Can't combine a vector with a matrix elementwise.");
+
+		BinaryExpression(const L& lhs, const R& rhs) : m_lhs(lhs), m_rhs(rhs) {}
+
+		template <typename... Index>
+		double operator()(Index... index) const { return Op::apply(m_lhs(index...), m_rhs(index...)); }
+		bool conforms(size_t w, size_t h) const { return m_lhs.conforms(w, h) && m_rhs.conforms(w, h); }
+		size_t width(void) const { return (L::rank != 0) ? m_lhs.width() : m_rhs.width(); }
+		size_t height(void) const { return (L::rank != 0) ? m_lhs.height() : m_rhs.height(); }
+
+	private:
+		L m_lhs;
+		R m_rhs;
+	};
+
+	template <typename Op, typename E>
+	class UnaryExpression : public Expression<UnaryExpression<Op, E> >
+	{
+	public:
+		static const int rank = E::rank;
+
+		explicit UnaryExpression(const E& operand) : m_operand(operand) {}
+
+		template <typename... Index>
+		double operator()(Index... index) const { return Op::apply(m_operand(index...)); }
+		bool conforms(size_t w, size_t h) const { return m_operand.conforms(w, h); }
+		size_t width(void) const { return m_operand.width(); }
+		size_t height(void) const { return m_operand.height(); }
+
+	private:
+		E m_operand;
+	};
+
+	namespace detail
+	{
+		struct Add { static double apply(double a, double b) { return a + b; } };
+		struct Subtract { static double apply(double a, double b) { return a - b; } };
+		struct Multiply { static double apply(double a, double b) { return a * b; } };
+		struct Divide { static double apply(double a, double b) { return a / b; } };
+		struct Min { static double apply(double a, double b) { return (b < a) ? b : a; } };
+		struct Max { static double apply(double a, double b) { return (a < b) ? b : a; } };
+		struct Negate { static double apply(double a) { return -a; } };
+		struct Abs { static double apply(double a) { return fabs(a); } };
+		struct Sqrt { static double apply(double a) { return sqrt(a); } };
+
+		/**
+		 * Maps each kind of argument an operator accepts to the node that represents it. Anything else has no 'type',
+		 * which keeps the operators below out of overload resolution.
+		 */
+		template <typename T, typename Enable = void>
+		struct Operand
+		{
+			static const bool isArray = false;
+		};
+
+		template <typename T>
+		struct Operand<T, typename std::enable_if<std::is_base_of<ExpressionBase, T>::value>::type>
+		{
+			typedef T type;
+			static const bool isArray = true;
+			static const T& make(const T& e) { return e; }
+		};
+
+		template <typename T>
+		struct Operand<T, typename std::enable_if<std::is_base_of<Matrix, T>::value>::type>
+		{
+			typedef MatrixOperand type;
+			static const bool isArray = true;
+			static MatrixOperand make(const T& m) { return MatrixOperand(m.row(0), m.stride(), m.width(), m.height()); }
+		};
+
+		template <typename T>
+		struct Operand<T, typename std::enable_if<std::is_base_of<Vector, T>::value>::type>
+		{
+			typedef VectorOperand type;
+			static const bool isArray = true;
+			static VectorOperand make(const T& v) { return VectorOperand(v.m_data, v.size()); }
+		};
+
+		template <typename T>
+		struct Operand<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+		{
+			typedef ScalarOperand type;
+			static const bool isArray = false;
+			static ScalarOperand make(T s) { return ScalarOperand((double)s); }
+		};
+
+		/// The node for 'L op R', defined when at least one side is a vector, matrix or expression.
+		template <typename Op, typename L, typename R,
+			bool Enable = Operand<L>::isArray || Operand<R>::isArray>
+		struct Binary
+		{
+		};
+
+		template <typename Op, typename L, typename R>
+		struct Binary<Op, L, R, true>
+		{
+			typedef BinaryExpression<Op, typename Operand<L>::type, typename Operand<R>::type> type;
+			static type make(const L& lhs, const R& rhs) { return type(Operand<L>::make(lhs), Operand<R>::make(rhs)); }
+		};
+
+		/// The node for 'L op s', defined when L is a vector, matrix or expression and s is a scalar.
+		template <typename Op, typename L, typename S,
+			bool Enable = Operand<L>::isArray && std::is_arithmetic<S>::value>
+		struct Scaled
+		{
+		};
+
+		template <typename Op, typename L, typename S>
+		struct Scaled<Op, L, S, true> : public Binary<Op, L, S>
+		{
+		};
+
+		/// The node for 'op E', defined when E is a vector, matrix or expression.
+		template <typename Op, typename E, bool Enable = Operand<E>::isArray>
+		struct Unary
+		{
+		};
+
+		template <typename Op, typename E>
+		struct Unary<Op, E, true>
+		{
+			typedef UnaryExpression<Op, typename Operand<E>::type> type;
+			static type make(const E& e) { return type(Operand<E>::make(e)); }
+		};
+	}
+
+	/**
+	 * Elementwise sums and differences of vectors, matrices and expressions; a scalar on either side applies to
+	 * every element.
+	 */
+	template <typename L, typename R>
+	typename detail::Binary<detail::Add, L, R>::type operator+(const L& lhs, const R& rhs) { return detail::Binary<detail::Add, L, R>::make(lhs, rhs); }
+
+	template <typename L, typename R>
+	typename detail::Binary<detail::Subtract, L, R>::type operator-(const L& lhs, const R& rhs) { return detail::Binary<detail::Subtract, L, R>::make(lhs, rhs); }
+
+	template <typename E>
+	typename detail::Unary<detail::Negate, E>::type operator-(const E& e) { return detail::Unary<detail::Negate, E>::make(e); }
+
+	/**
+	 * Scaling by a scalar. A product of two matrices is a matrix product, not an elementwise one, so it isn't offered
+	 * here; see elementwiseProduct.
+	 */
+	template <typename L, typename S>
+	typename detail::Scaled<detail::Multiply, L, S>::type operator*(const L& lhs, S s) { return detail::Scaled<detail::Multiply, L, S>::make(lhs, s); }
+
+	template <typename S, typename R>
+	typename detail::Scaled<detail::Multiply, R, S>::type operator*(S s, const R& rhs) { return detail::Scaled<detail::Multiply, R, S>::make(rhs, s); }
+
+	template <typename L, typename S>
+	typename detail::Scaled<detail::Divide, L, S>::type operator/(const L& lhs, S s) { return detail::Scaled<detail::Divide, L, S>::make(lhs, s); }
+
+	/**
+	 * Other elementwise operations.
+	 */
+	template <typename L, typename R>
+	typename detail::Binary<detail::Multiply, L, R>::type elementwiseProduct(const L& lhs, const R& rhs) { return detail::Binary<detail::Multiply, L, R>::make(lhs, rhs); }
+
+	template <typename L, typename R>
+	typename detail::Binary<detail::Divide, L, R>::type elementwiseQuotient(const L& lhs, const R& rhs) { return detail::Binary<detail::Divide, L, R>::make(lhs, rhs); }
+
+	template <typename L, typename R>
+	typename detail::Binary<detail::Min, L, R>::type elementwiseMin(const L& lhs, const R& rhs) { return detail::Binary<detail::Min, L, R>::make(lhs, rhs); }
+
+	template <typename L, typename R>
+	typename detail::Binary<detail::Max, L, R>::type elementwiseMax(const L& lhs, const R& rhs) { return detail::Binary<detail::Max, L, R>::make(lhs, rhs); }
+
+	template <typename E>
+	typename detail::Unary<detail::Abs, E>::type elementwiseAbs(const E& e) { return detail::Unary<detail::Abs, E>::make(e); }
+
+	template <typename E>
+	typename detail::Unary<detail::Sqrt, E>::type elementwiseSqrt(const E& e) { return detail::Unary<detail::Sqrt, E>::make(e); }
+}
+
+#endif
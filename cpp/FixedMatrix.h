@@ -0,0 +1,329 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _FIXEDMATRIX_
+#define _FIXEDMATRIX_
+
+#include <stdlib.h>
+#include "FixedVector.h"
+#include "Matrix.h"
+
+namespace LibMath
+{
+	namespace detail
+	{
+		/**
+		 * Closed form determinants and inverses (adjugate over determinant) of small square arrays.
+		 */
+		template <typename T, size_t N> struct FixedSquare;
+
+		template <typename T> struct FixedSquare<T, 1>
+		{
+			static constexpr T determinant(const T (&a)[1][1]) { return a[0][0]; }
+			static constexpr void adjugate(const T (&)[1][1], T (&b)[1][1]) { b[0][0] = (T)1; }
+		};
+
+		template <typename T> struct FixedSquare<T, 2>
+		{
+			static constexpr T determinant(const T (&a)[2][2]) { return a[0][0] * a[1][1] - a[0][1] * a[1][0]; }
+			static constexpr void adjugate(const T (&a)[2][2], T (&b)[2][2])
+			{
+				b[0][0] = a[1][1];  b[0][1] = -a[0][1];
+				b[1][0] = -a[1][0]; b[1][1] = a[0][0];
+			}
+		};
+
+		template <typename T> struct FixedSquare<T, 3>
+		{
+			static constexpr T cofactor(const T (&a)[3][3], size_t r, size_t c)
+			{
+				return a[(r + 1) % 3][(c + 1) % 3] * a[(r + 2) % 3][(c + 2) % 3] - a[(r + 1) % 3][(c + 2) % 3] * a[(r + 2) % 3][(c + 1) % 3];
+			}
+			static constexpr T determinant(const T (&a)[3][3])
+			{
+				return a[0][0] * cofactor(a, 0, 0) + a[0][1] * cofactor(a, 0, 1) + a[0][2] * cofactor(a, 0, 2);
+			}
+			static constexpr void adjugate(const T (&a)[3][3], T (&b)[3][3])
+			{
+				for (size_t i = 0; i < 3; ++i)
+					for (size_t j = 0; j < 3; ++j)
+						b[i][j] = cofactor(a, j, i);
+			}
+		};
+
+		template <typename T> struct FixedSquare<T, 4>
+		{
+			// Expansion in 2x2 minors of the top two rows (s) and the bottom two rows (c).
+			static constexpr T determinant(const T (&a)[4][4])
+			{
+				T s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+				T s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+				T s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+				T s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+				T s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+				T s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+				T c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+				T c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+				T c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+				T c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+				T c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+				T c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+				return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+			}
+			static constexpr void adjugate(const T (&a)[4][4], T (&b)[4][4])
+			{
+				T s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+				T s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+				T s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+				T s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+				T s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+				T s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+				T c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+				T c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+				T c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+				T c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+				T c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+				T c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+				b[0][0] = a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3;
+				b[0][1] = -a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3;
+				b[0][2] = a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3;
+				b[0][3] = -a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3;
+				b[1][0] = -a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1;
+				b[1][1] = a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1;
+				b[1][2] = -a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1;
+				b[1][3] = a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1;
+				b[2][0] = a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0;
+				b[2][1] = -a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0;
+				b[2][2] = a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0;
+				b[2][3] = -a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0;
+				b[3][0] = -a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0;
+				b[3][1] = a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0;
+				b[3][2] = -a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0;
+				b[3][3] = a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0;
+			}
+		};
+	}
+
+	/**
+	 * A matrix whose dimensions are known at compile time: R rows of C elements, stored by row inside the object.
+	 * Like FixedVector it is a value type with stack storage, fully unrolled loops, and constexpr operations.
+	 * Determinant and inverse are closed form and limited to square matrices of at most 4x4.
+	 */
+	template <typename T, size_t R, size_t C>
+	class FixedMatrix
+	{
+	public:
+		/**
+		 * The zero matrix.
+		 */
+		constexpr FixedMatrix(void) : m_data() {}
+
+		/**
+		 * Builds the matrix from exactly R x C elements, given row by row.
+		 */
+		template <typename... Rest, typename = typename std::enable_if<sizeof...(Rest) + 1 == R * C>::type>
+		constexpr FixedMatrix(T first, Rest... rest) : m_data()
+		{
+			const T values[R * C] = { first, (T)rest... };
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					m_data[i][j] = values[i * C + j];
+		}
+
+		/**
+		 * Returns the identity matrix.
+		 */
+		static constexpr FixedMatrix identity(void)
+		{
+			static_assert(R == C, "Only square matrices have an identity.");
+			FixedMatrix result;
+			for (size_t i = 0; i < R; ++i)
+				result.m_data[i][i] = (T)1;
+			return result;
+		}
+
+		/**
+		 * Copies the top left R x C elements of a dynamic matrix, which must be at least that large.
+		 */
+		static FixedMatrix fromMatrix(const Matrix* m)
+		{
+			FixedMatrix result;
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					result.m_data[i][j] = (T)m->get(i, j);
+			return result;
+		}
+
+		/**
+		 * Copies this matrix into the top left R x C elements of a dynamic matrix.
+		 */
+		void toMatrix(Matrix* m) const
+		{
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					m->set(i, j, (double)m_data[i][j]);
+		}
+
+		/**
+		 * Returns the number of rows and columns; width and height have the same meaning as they do for Matrix.
+		 */
+		static constexpr size_t width(void) { return R; }
+		static constexpr size_t height(void) { return C; }
+
+		constexpr void set(size_t i, size_t j, T value) { m_data[i][j] = value; }
+		constexpr T get(size_t i, size_t j) const { return m_data[i][j]; }
+		constexpr T& operator()(size_t i, size_t j) { return m_data[i][j]; }
+		constexpr const T& operator()(size_t i, size_t j) const { return m_data[i][j]; }
+
+		/**
+		 * Returns row i or column j as a vector.
+		 */
+		constexpr FixedVector<T, C> row(size_t i) const
+		{
+			FixedVector<T, C> result;
+			for (size_t j = 0; j < C; ++j)
+				result[j] = m_data[i][j];
+			return result;
+		}
+		constexpr FixedVector<T, R> column(size_t j) const
+		{
+			FixedVector<T, R> result;
+			for (size_t i = 0; i < R; ++i)
+				result[i] = m_data[i][j];
+			return result;
+		}
+
+		/**
+		 * Returns the transpose.
+		 */
+		constexpr FixedMatrix<T, C, R> transpose(void) const
+		{
+			FixedMatrix<T, C, R> result;
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					result.m_data[j][i] = m_data[i][j];
+			return result;
+		}
+
+		/**
+		 * Returns the determinant. Square matrices up to 4x4 only.
+		 */
+		constexpr T determinant(void) const
+		{
+			static_assert(R == C && R <= 4, "Determinants are only provided for square matrices up to 4x4.");
+			return detail::FixedSquare<T, R>::determinant(m_data);
+		}
+
+		/**
+		 * Computes the inverse into 'result'. Returns false, leaving 'result' alone, if the matrix is singular.
+		 * Square matrices up to 4x4 only.
+		 */
+		constexpr bool inverse(FixedMatrix* result) const
+		{
+			static_assert(R == C && R <= 4, "Inverses are only provided for square matrices up to 4x4.");
+			T det = detail::FixedSquare<T, R>::determinant(m_data);
+			if (det == T())
+				return false;
+			FixedMatrix adjugate;
+			detail::FixedSquare<T, R>::adjugate(m_data, adjugate.m_data);
+			*result = adjugate * ((T)1 / det);
+			return true;
+		}
+
+		/**
+		 * Returns this x B.
+		 */
+		template <size_t K>
+		constexpr FixedMatrix<T, R, K> operator*(const FixedMatrix<T, C, K>& B) const
+		{
+			FixedMatrix<T, R, K> result;
+			for (size_t i = 0; i < R; ++i)
+				for (size_t k = 0; k < C; ++k)
+					for (size_t j = 0; j < K; ++j)
+						result.m_data[i][j] += m_data[i][k] * B.m_data[k][j];
+			return result;
+		}
+
+		/**
+		 * Returns this x v.
+		 */
+		constexpr FixedVector<T, R> operator*(const FixedVector<T, C>& v) const
+		{
+			FixedVector<T, R> result;
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					result[i] += m_data[i][j] * v[j];
+			return result;
+		}
+
+		constexpr FixedMatrix& operator+=(const FixedMatrix& B)
+		{
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					m_data[i][j] += B.m_data[i][j];
+			return *this;
+		}
+
+		constexpr FixedMatrix& operator-=(const FixedMatrix& B)
+		{
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					m_data[i][j] -= B.m_data[i][j];
+			return *this;
+		}
+
+		constexpr FixedMatrix& operator*=(T s)
+		{
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					m_data[i][j] *= s;
+			return *this;
+		}
+
+		constexpr FixedMatrix operator+(const FixedMatrix& B) const { FixedMatrix result = *this; result += B; return result; }
+		constexpr FixedMatrix operator-(const FixedMatrix& B) const { FixedMatrix result = *this; result -= B; return result; }
+		constexpr FixedMatrix operator*(T s) const { FixedMatrix result = *this; result *= s; return result; }
+
+		constexpr bool operator==(const FixedMatrix& B) const
+		{
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					if (m_data[i][j] != B.m_data[i][j])
+						return false;
+			return true;
+		}
+		constexpr bool operator!=(const FixedMatrix& B) const { return !(*this == B); }
+
+	public:
+		T m_data[R][C];
+	};
+
+	template <typename T, size_t R, size_t C>
+	constexpr FixedMatrix<T, R, C> operator*(T s, const FixedMatrix<T, R, C>& m) { return m * s; }
+
+	typedef FixedMatrix<double, 2, 2> Matrix2;
+	typedef FixedMatrix<double, 3, 3> Matrix3;
+	typedef FixedMatrix<double, 4, 4> Matrix4;
+}
+
+#endif
@@ -0,0 +1,176 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _FIXEDVECTOR_
+#define _FIXEDVECTOR_
+
+#include <math.h>
+#include <stdlib.h>
+#include <type_traits>
+#include "Vector.h"
+
+namespace LibMath
+{
+	/**
+	 * A vector whose length is known at compile time. Storage is an array inside the object, so it lives on the stack
+	 * (or inline in whatever holds it) and is copied by value; the loops have constant trip counts and unroll completely.
+	 * Everything except length and normalization is constexpr.
+	 */
+	template <typename T, size_t N>
+	class FixedVector
+	{
+	public:
+		/**
+		 * The zero vector.
+		 */
+		constexpr FixedVector(void) : m_data() {}
+
+		/**
+		 * Builds the vector from exactly N components, e.g. FixedVector<double, 3>(x, y, z).
+		 */
+		template <typename... Rest, typename = typename std::enable_if<sizeof...(Rest) + 1 == N>::type>
+		constexpr FixedVector(T first, Rest... rest) : m_data{ first, (T)rest... } {}
+
+		/**
+		 * Copies the first N elements of a dynamic vector, which must have at least that many.
+		 */
+		static FixedVector fromVector(const Vector* v)
+		{
+			FixedVector result;
+			for (size_t i = 0; i < N; ++i)
+				result.m_data[i] = (T)v->m_data[i];
+			return result;
+		}
+
+		/**
+		 * Copies this vector into the first N elements of a dynamic vector.
+		 */
+		void toVector(Vector* v) const
+		{
+			for (size_t i = 0; i < N; ++i)
+				v->m_data[i] = (double)m_data[i];
+		}
+
+		/**
+		 * Returns the number of elements in the vector.
+		 */
+		static constexpr size_t size(void) { return N; }
+
+		constexpr T& operator[](size_t i) { return m_data[i]; }
+		constexpr const T& operator[](size_t i) const { return m_data[i]; }
+
+		/**
+		 * Returns the dot product of this vector and B.
+		 */
+		constexpr T dot(const FixedVector& B) const
+		{
+			T sum = T();
+			for (size_t i = 0; i < N; ++i)
+				sum += m_data[i] * B.m_data[i];
+			return sum;
+		}
+
+		/**
+		 * Returns the cross product of this vector and B. Three dimensional vectors only.
+		 */
+		constexpr FixedVector cross(const FixedVector& B) const
+		{
+			static_assert(N == 3, "The cross product is only defined for three dimensional vectors.");
+			return FixedVector(m_data[1] * B.m_data[2] - m_data[2] * B.m_data[1],
+				m_data[2] * B.m_data[0] - m_data[0] * B.m_data[2],
+				m_data[0] * B.m_data[1] - m_data[1] * B.m_data[0]);
+		}
+
+		/**
+		 * Returns the length of the vector.
+		 */
+		T length(void) const { return (T)sqrt(dot(*this)); }
+
+		/**
+		 * Normalizes the vector. The zero vector is left alone.
+		 */
+		void normalize(void)
+		{
+			T len = length();
+			if (len != T())
+				*this *= (T)1 / len;
+		}
+
+		/**
+		 * Returns the normalized vector.
+		 */
+		FixedVector normalized(void) const
+		{
+			FixedVector result = *this;
+			result.normalize();
+			return result;
+		}
+
+		constexpr FixedVector& operator+=(const FixedVector& B)
+		{
+			for (size_t i = 0; i < N; ++i)
+				m_data[i] += B.m_data[i];
+			return *this;
+		}
+
+		constexpr FixedVector& operator-=(const FixedVector& B)
+		{
+			for (size_t i = 0; i < N; ++i)
+				m_data[i] -= B.m_data[i];
+			return *this;
+		}
+
+		constexpr FixedVector& operator*=(T s)
+		{
+			for (size_t i = 0; i < N; ++i)
+				m_data[i] *= s;
+			return *this;
+		}
+
+		constexpr FixedVector operator+(const FixedVector& B) const { FixedVector result = *this; result += B; return result; }
+		constexpr FixedVector operator-(const FixedVector& B) const { FixedVector result = *this; result -= B; return result; }
+		constexpr FixedVector operator*(T s) const { FixedVector result = *this; result *= s; return result; }
+		constexpr FixedVector operator-(void) const { return *this * (T)-1; }
+
+		constexpr bool operator==(const FixedVector& B) const
+		{
+			for (size_t i = 0; i < N; ++i)
+				if (m_data[i] != B.m_data[i])
+					return false;
+			return true;
+		}
+		constexpr bool operator!=(const FixedVector& B) const { return !(*this == B); }
+
+	public:
+		T m_data[N];
+	};
+
+	template <typename T, size_t N>
+	constexpr FixedVector<T, N> operator*(T s, const FixedVector<T, N>& v) { return v * s; }
+
+	typedef FixedVector<double, 2> Vector2;
+	typedef FixedVector<double, 3> Vector3;
+	typedef FixedVector<double, 4> Vector4;
+}
+
+#endif
@@ -0,0 +1,387 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Gemm.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
+namespace LibMath
+{
+	namespace
+	{
+	// Microkernel shape (MR rows by NR columns of C, held in registers) and cache blocking: a KC x NR panel of B stays
+	// in L1, an MC x KC block of A in L2, and a KC x NC block of B in L3.
+#if defined(__AVX512F__)
+	const size_t MR = 8;
+	const size_t NR = 24;
+	const size_t KC = 192;
+	const size_t MC = 192;
+#elif defined(__AVX2__) && defined(__FMA__)
+	const size_t MR = 6;
+	const size_t NR = 8;
+	const size_t KC = 256;
+	const size_t MC = 96;
+#else
+	const size_t MR = 4;
+	const size_t NR = 8;
+	const size_t KC = 256;
+	const size_t MC = 128;
+#endif
+	const size_t NC = 4080 - (4080 % NR);
+
+	/// Below this many multiply-adds, packing costs more than it saves.
+	const size_t SMALL_PRODUCT = 32 * 32 * 32;
+
+	/// Below this many multiply-adds, a product isn't worth starting threads for, and no thread gets less than this.
+	const size_t MIN_PRODUCT_PER_THREAD = 128 * 128 * 128;
+
+	/// Matrix elements each thread should stream through in a matrix-vector product.
+	const size_t MIN_ELEMENTS_PER_THREAD = 256 * 1024;
+
+	/// Packs op(A)[row0 .. row0+mc, col0 .. col0+kc] into MR row panels, each stored column by column and zero padded.
+	void packA(bool transA, const double* A, size_t lda, size_t row0, size_t col0, size_t mc, size_t kc, double* packed)
+	{
+		for (size_t panel = 0; panel < mc; panel += MR)
+		{
+			size_t rows = std::min(MR, mc - panel);
+			for (size_t p = 0; p < kc; ++p)
+			{
+				for (size_t i = 0; i < MR; ++i)
+				{
+					double value = (double)0.0;
+					if (i < rows)
+					{
+						size_t r = row0 + panel + i;
+						size_t c = col0 + p;
+						value = transA ? A[c * lda + r] : A[r * lda + c];
+					}
+					*packed++ = value;
+				}
+			}
+		}
+	}
+
+	/// Packs op(B)[row0 .. row0+kc, col0 .. col0+nc] into NR column panels, each stored row by row and zero padded.
+	void packB(bool transB, const double* B, size_t ldb, size_t row0, size_t col0, size_t kc, size_t nc, double* packed)
+	{
+		for (size_t panel = 0; panel < nc; panel += NR)
+		{
+			size_t cols = std::min(NR, nc - panel);
+			for (size_t p = 0; p < kc; ++p)
+			{
+				size_t r = row0 + p;
+				if (!transB && (cols == NR))
+				{
+					memcpy(packed, B + r * ldb + col0 + panel, NR * sizeof(double));
+					packed += NR;
+					continue;
+				}
+				for (size_t j = 0; j < NR; ++j)
+				{
+					size_t c = col0 + panel + j;
+					*packed++ = (j < cols) ? (transB ? B[c * ldb + r] : B[r * ldb + c]) : (double)0.0;
+				}
+			}
+		}
+	}
+
+	/// ab = A panel x B panel, MR x NR, row-major.
+	void microKernel(size_t kc, const double* a, const double* b, double* ab)
+	{
+#if defined(__AVX512F__)
+		__m512d c[MR][3];
+		for (size_t i = 0; i < MR; ++i)
+			c[i][0] = c[i][1] = c[i][2] = _mm512_setzero_pd();
+		for (size_t p = 0; p < kc; ++p, a += MR, b += NR)
+		{
+			__m512d b0 = _mm512_loadu_pd(b);
+			__m512d b1 = _mm512_loadu_pd(b + 8);
+			__m512d b2 = _mm512_loadu_pd(b + 16);
+			for (size_t i = 0; i < MR; ++i)
+			{
+				__m512d ai = _mm512_set1_pd(a[i]);
+				c[i][0] = _mm512_fmadd_pd(ai, b0, c[i][0]);
+				c[i][1] = _mm512_fmadd_pd(ai, b1, c[i][1]);
+				c[i][2] = _mm512_fmadd_pd(ai, b2, c[i][2]);
+			}
+		}
+		for (size_t i = 0; i < MR; ++i)
+		{
+			_mm512_storeu_pd(ab + i * NR, c[i][0]);
+			_mm512_storeu_pd(ab + i * NR + 8, c[i][1]);
+			_mm512_storeu_pd(ab + i * NR + 16, c[i][2]);
+		}
+#elif defined(__AVX2__) && defined(__FMA__)
+		__m256d c[MR][2];
+		for (size_t i = 0; i < MR; ++i)
+			c[i][0] = c[i][1] = _mm256_setzero_pd();
+		for (size_t p = 0; p < kc; ++p, a += MR, b += NR)
+		{
+			__m256d b0 = _mm256_loadu_pd(b);
+			__m256d b1 = _mm256_loadu_pd(b + 4);
+			for (size_t i = 0; i < MR; ++i)
+			{
+				__m256d ai = _mm256_broadcast_sd(a + i);
+				c[i][0] = _mm256_fmadd_pd(ai, b0, c[i][0]);
+				c[i][1] = _mm256_fmadd_pd(ai, b1, c[i][1]);
+			}
+		}
+		for (size_t i = 0; i < MR; ++i)
+		{
+			_mm256_storeu_pd(ab + i * NR, c[i][0]);
+			_mm256_storeu_pd(ab + i * NR + 4, c[i][1]);
+		}
+#else
+		double c[MR][NR] = { { 0 } };
+		for (size_t p = 0; p < kc; ++p, a += MR, b += NR)
+		{
+#pragma GCC unroll 4
+			for (size_t i = 0; i < MR; ++i)
+			{
+				double ai = a[i];
+#pragma GCC unroll 8
+				for (size_t j = 0; j < NR; ++j)
+					c[i][j] += ai * b[j];
+			}
+		}
+		memcpy(ab, c, sizeof(c));
+#endif
+	}
+
+	/// C = alpha * ab + beta * C over the top left rows x cols of the tile. C isn't read when beta is zero.
+	inline void updateTile(const double* ab, size_t rows, size_t cols, double alpha, double beta, double* C, size_t ldc)
+	{
+		for (size_t i = 0; i < rows; ++i)
+		{
+			double* c = C + i * ldc;
+			const double* t = ab + i * NR;
+			if (beta == (double)0.0)
+			{
+				for (size_t j = 0; j < cols; ++j)
+					c[j] = alpha * t[j];
+			}
+			else
+			{
+				for (size_t j = 0; j < cols; ++j)
+					c[j] = alpha * t[j] + beta * c[j];
+			}
+		}
+	}
+
+	/// Straightforward i-p-j loops, for products too small to be worth packing.
+	void multiplySmall(bool transA, bool transB, size_t m, size_t n, size_t k, double alpha,
+		const double* A, size_t lda, const double* B, size_t ldb, double beta, double* C, size_t ldc)
+	{
+		for (size_t i = 0; i < m; ++i)
+		{
+			double* c = C + i * ldc;
+			for (size_t j = 0; j < n; ++j)
+				c[j] = (beta == (double)0.0) ? (double)0.0 : beta * c[j];
+			for (size_t p = 0; p < k; ++p)
+			{
+				double a = alpha * (transA ? A[p * lda + i] : A[i * lda + p]);
+				if (transB)
+				{
+					for (size_t j = 0; j < n; ++j)
+						c[j] += a * B[j * ldb + p];
+				}
+				else
+				{
+					const double* b = B + p * ldb;
+					for (size_t j = 0; j < n; ++j)
+						c[j] += a * b[j];
+				}
+			}
+		}
+	}
+
+	/// The packed product on the calling thread.
+	void multiplyBlocked(bool transA, bool transB, size_t m, size_t n, size_t k, double alpha,
+		const double* A, size_t lda, const double* B, size_t ldb, double beta, double* C, size_t ldc)
+	{
+		if ((k == 0) || (alpha == (double)0.0) || (m * n * k <= SMALL_PRODUCT))
+		{
+			multiplySmall(transA, transB, m, n, (alpha == (double)0.0) ? 0 : k, alpha, A, lda, B, ldb, beta, C, ldc);
+			return;
+		}
+
+		std::vector<double> packedA(std::min(MC, (m + MR - 1) / MR * MR) * std::min(KC, k));
+		std::vector<double> packedB(std::min(KC, k) * std::min(NC, (n + NR - 1) / NR * NR));
+		double ab[MR * NR];
+
+		for (size_t jc = 0; jc < n; jc += NC)
+		{
+			size_t nc = std::min(NC, n - jc);
+			for (size_t pc = 0; pc < k; pc += KC)
+			{
+				size_t kc = std::min(KC, k - pc);
+				packB(transB, B, ldb, pc, jc, kc, nc, packedB.data());
+
+				// Only the first pass over k applies beta; later ones accumulate.
+				double betaPass = (pc == 0) ? beta : (double)1.0;
+				for (size_t ic = 0; ic < m; ic += MC)
+				{
+					size_t mc = std::min(MC, m - ic);
+					packA(transA, A, lda, ic, pc, mc, kc, packedA.data());
+
+					for (size_t jr = 0; jr < nc; jr += NR)
+					{
+						for (size_t ir = 0; ir < mc; ir += MR)
+						{
+							microKernel(kc, packedA.data() + ir * kc, packedB.data() + jr * kc, ab);
+							updateTile(ab, std::min(MR, mc - ir), std::min(NR, nc - jr), alpha, betaPass, C + (ic + ir) * ldc + jc + jr, ldc);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/// Splits 'count' into 'parts' ranges whose boundaries are multiples of 'align'; returns the start of range 'part'.
+	size_t partitionStart(size_t count, size_t parts, size_t part, size_t align)
+	{
+		size_t blocks = (count + align - 1) / align;
+		size_t start = (blocks * part / parts) * align;
+		return std::min(start, count);
+	}
+	}
+
+	void Gemm::multiply(bool transA, bool transB, size_t m, size_t n, size_t k, double alpha,
+		const double* A, size_t lda, const double* B, size_t ldb, double beta, double* C, size_t ldc)
+	{
+		// Sanity check.
+		if ((m == 0) || (n == 0))
+			return;
+
+		size_t work = m * n * k;
+		size_t numThreads = std::min(Parallel::numThreads(), work / MIN_PRODUCT_PER_THREAD);
+		if (numThreads <= 1)
+		{
+			multiplyBlocked(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+			return;
+		}
+
+		// Tile C in a grid of rowTiles x colTiles, one tile per thread, with the grid shaped like C so that the
+		// tiles are close to square and each thread packs as little of A and B as possible.
+		size_t rowTiles = 1;
+		for (size_t candidate = 1; candidate <= numThreads; ++candidate)
+		{
+			if ((numThreads % candidate) != 0)
+				continue;
+			double tileRows = (double)m / (double)candidate;
+			double tileCols = (double)n / (double)(numThreads / candidate);
+			double bestRows = (double)m / (double)rowTiles;
+			double bestCols = (double)n / (double)(numThreads / rowTiles);
+			if (tileRows + tileCols < bestRows + bestCols)
+				rowTiles = candidate;
+		}
+		size_t colTiles = numThreads / rowTiles;
+
+		Parallel::forRange(numThreads, 1, [&](size_t first, size_t last) {
+			for (size_t tile = first; tile < last; ++tile)
+			{
+				size_t ti = tile / colTiles;
+				size_t tj = tile % colTiles;
+				size_t i0 = partitionStart(m, rowTiles, ti, MR);
+				size_t i1 = partitionStart(m, rowTiles, ti + 1, MR);
+				size_t j0 = partitionStart(n, colTiles, tj, NR);
+				size_t j1 = partitionStart(n, colTiles, tj + 1, NR);
+				if ((i0 == i1) || (j0 == j1))
+					continue;
+
+				const double* tileA = transA ? (A + i0) : (A + i0 * lda);
+				const double* tileB = transB ? (B + j0 * ldb) : (B + j0);
+				multiplyBlocked(transA, transB, i1 - i0, j1 - j0, k, alpha, tileA, lda, tileB, ldb, beta, C + i0 * ldc + j0, ldc);
+			}
+		});
+	}
+
+	void Gemm::multiplyVector(bool transA, size_t m, size_t n, double alpha, const double* A, size_t lda,
+		const double* x, double beta, double* y)
+	{
+		size_t outputs = transA ? n : m;
+		size_t inputs = transA ? m : n;
+
+		// Sanity check.
+		if (outputs == 0)
+			return;
+
+		size_t minChunk = std::max((size_t)1, MIN_ELEMENTS_PER_THREAD / std::max((size_t)1, inputs));
+		if (!transA)
+		{
+			// Each thread takes a block of rows and dots them with x, four rows at a time.
+			Parallel::forRange(m, minChunk, [&](size_t begin, size_t end) {
+				size_t i = begin;
+				for (; i + 4 <= end; i += 4)
+				{
+					const double* a0 = A + i * lda;
+					const double* a1 = a0 + lda;
+					const double* a2 = a1 + lda;
+					const double* a3 = a2 + lda;
+					double s0 = (double)0.0, s1 = (double)0.0, s2 = (double)0.0, s3 = (double)0.0;
+					for (size_t j = 0; j < n; ++j)
+					{
+						double xj = x[j];
+						s0 += a0[j] * xj;
+						s1 += a1[j] * xj;
+						s2 += a2[j] * xj;
+						s3 += a3[j] * xj;
+					}
+					double sums[4] = { s0, s1, s2, s3 };
+					for (size_t r = 0; r < 4; ++r)
+						y[i + r] = (beta == (double)0.0) ? alpha * sums[r] : alpha * sums[r] + beta * y[i + r];
+				}
+				for (; i < end; ++i)
+				{
+					const double* a = A + i * lda;
+					double sum = (double)0.0;
+					for (size_t j = 0; j < n; ++j)
+						sum += a[j] * x[j];
+					y[i] = (beta == (double)0.0) ? alpha * sum : alpha * sum + beta * y[i];
+				}
+			});
+		}
+		else
+		{
+			// y = A^T x: each thread owns a block of y and sweeps down the rows of A, adding x[i] times its part of row i.
+			Parallel::forRange(n, std::max(minChunk, NR), [&](size_t begin, size_t end) {
+				double* out = y + begin;
+				size_t count = end - begin;
+				for (size_t j = 0; j < count; ++j)
+					out[j] = (beta == (double)0.0) ? (double)0.0 : beta * out[j];
+				for (size_t i = 0; i < inputs; ++i)
+				{
+					const double* a = A + i * lda + begin;
+					double xi = alpha * x[i];
+					for (size_t j = 0; j < count; ++j)
+						out[j] += xi * a[j];
+				}
+			});
+		}
+	}
+}
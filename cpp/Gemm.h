@@ -0,0 +1,57 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _GEMM_
+#define _GEMM_
+
+#include <stdlib.h>
+
+namespace LibMath
+{
+	/**
+	 * General matrix multiply over row-major buffers, in the style of BLAS dgemm: C = alpha * op(A) x op(B) + beta * C,
+	 * where op(X) is X or its transpose. A is m x k, B is k x n and C is m x n after the transposes; 'lda', 'ldb' and
+	 * 'ldc' are the row strides of the buffers as stored.
+	 *
+	 * Blocks of A and B are packed into contiguous panels sized for the caches, and a register-blocked microkernel
+	 * multiplies them: AVX-512 or AVX2 with FMA when the build targets them (see LIBMATH_NATIVE), plain C++ otherwise.
+	 *
+	 * Large enough products are split across Parallel::numThreads() threads (see Parallel::setNumThreads); small ones
+	 * stay on the calling thread.
+	 */
+	class Gemm
+	{
+	public:
+		static void multiply(bool transA, bool transB, size_t m, size_t n, size_t k, double alpha,
+			const double* A, size_t lda, const double* B, size_t ldb, double beta, double* C, size_t ldc);
+
+		/**
+		 * Matrix-vector product, y = alpha * op(A) x + beta * y, where A is stored as m x n with row stride 'lda'.
+		 * Rows (or, transposed, columns) of the result are split across threads once A is large enough.
+		 */
+		static void multiplyVector(bool transA, size_t m, size_t n, double alpha, const double* A, size_t lda,
+			const double* x, double beta, double* y);
+	};
+}
+
+#endif
@@ -0,0 +1,379 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "GeoIndex.h"
+#include "Distance.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace LibMath
+{
+	namespace
+	{
+	const double   PI = (double)(3.141592653589793238);
+	const uint64_t MAGIC = 0x3158444e494f4547ULL; // "GEOINDX1"
+	const size_t   HEADER_WORDS = 4;               // magic, number of points, leaf size, reserved
+	const size_t   LEAF_SIZE = 8;                  // ranges this small are scanned rather than split
+
+	/// Bytes needed for an index of 'numPoints' points.
+	inline size_t bufferSize(size_t numPoints)
+	{
+		return (HEADER_WORDS + 4 * numPoints) * sizeof(uint64_t) + ((numPoints + 7) & ~(size_t)7);
+	}
+
+	/// Great circle distance, in meters, of a squared chord between two unit vectors.
+	inline double chordToMeters(double chordSq)
+	{
+		double halfChord = (double)0.5 * sqrt(chordSq);
+		if (halfChord > (double)1.0)
+			halfChord = (double)1.0;
+		return (double)2.0 * Distance::EARTH_RADIUS * asin(halfChord);
+	}
+
+	/// Orders the points in [begin, end) of 'order' into an implicit k-d tree: the median of the widest axis goes in the
+	/// middle, with the smaller half before it and the larger half after it.
+	void buildRange(const double* points, size_t* order, uint8_t* axes, size_t begin, size_t end, size_t parallelDepth)
+	{
+		const size_t MIN_POINTS_PER_THREAD = 16384;
+
+		if (end - begin <= LEAF_SIZE)
+		{
+			return;
+		}
+
+		double minimum[3] = { points[order[begin] * 3], points[order[begin] * 3 + 1], points[order[begin] * 3 + 2] };
+		double maximum[3] = { minimum[0], minimum[1], minimum[2] };
+		for (size_t i = begin + 1; i < end; ++i)
+		{
+			const double* point = points + order[i] * 3;
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				minimum[axis] = std::min(minimum[axis], point[axis]);
+				maximum[axis] = std::max(maximum[axis], point[axis]);
+			}
+		}
+		uint8_t axis = 0;
+		for (uint8_t i = 1; i < 3; ++i)
+		{
+			if (maximum[i] - minimum[i] > maximum[axis] - minimum[axis])
+				axis = i;
+		}
+
+		size_t mid = begin + (end - begin) / 2;
+		std::nth_element(order + begin, order + mid, order + end, [points, axis](size_t a, size_t b) {
+			return points[a * 3 + axis] < points[b * 3 + axis];
+		});
+		axes[mid] = axis;
+
+		// The two halves are independent, so the top of the tree can be split between threads.
+		if ((parallelDepth > 0) && (end - begin >= 2 * MIN_POINTS_PER_THREAD))
+		{
+			Parallel::forRange(2, 1, [&](size_t first, size_t last) {
+				for (size_t half = first; half < last; ++half)
+				{
+					if (half == 0)
+						buildRange(points, order, axes, begin, mid, parallelDepth - 1);
+					else
+						buildRange(points, order, axes, mid + 1, end, parallelDepth - 1);
+				}
+			});
+		}
+		else
+		{
+			buildRange(points, order, axes, begin, mid, 0);
+			buildRange(points, order, axes, mid + 1, end, 0);
+		}
+	}
+
+	/// Read only view of the tree arrays, shared by the queries.
+	struct TreeView
+	{
+		const double*   xyz;
+		const uint64_t* ids;
+		const uint8_t*  axes;
+		size_t          leafSize;
+
+		inline double squaredChord(const double* query, size_t pos) const
+		{
+			const double* point = xyz + pos * 3;
+			double dx = query[0] - point[0];
+			double dy = query[1] - point[1];
+			double dz = query[2] - point[2];
+			return dx * dx + dy * dy + dz * dz;
+		}
+
+		/// Keeps the k closest positions in 'heap', a max heap on squared chord length.
+		void nearest(const double* query, size_t k, size_t begin, size_t end, std::vector<std::pair<double, size_t> >& heap) const
+		{
+			if (end - begin <= leafSize)
+			{
+				for (size_t pos = begin; pos < end; ++pos)
+					offer(squaredChord(query, pos), pos, k, heap);
+				return;
+			}
+
+			size_t mid = begin + (end - begin) / 2;
+			double diff = query[axes[mid]] - xyz[mid * 3 + axes[mid]];
+			offer(squaredChord(query, mid), mid, k, heap);
+			if (diff < (double)0.0)
+			{
+				nearest(query, k, begin, mid, heap);
+				if ((heap.size() < k) || (diff * diff < heap.front().first))
+					nearest(query, k, mid + 1, end, heap);
+			}
+			else
+			{
+				nearest(query, k, mid + 1, end, heap);
+				if ((heap.size() < k) || (diff * diff < heap.front().first))
+					nearest(query, k, begin, mid, heap);
+			}
+		}
+
+		static inline void offer(double chordSq, size_t pos, size_t k, std::vector<std::pair<double, size_t> >& heap)
+		{
+			if (heap.size() < k)
+			{
+				heap.push_back(std::make_pair(chordSq, pos));
+				std::push_heap(heap.begin(), heap.end());
+			}
+			else if (chordSq < heap.front().first)
+			{
+				std::pop_heap(heap.begin(), heap.end());
+				heap.back() = std::make_pair(chordSq, pos);
+				std::push_heap(heap.begin(), heap.end());
+			}
+		}
+
+		/// Calls fn(pos, chordSq) for every position whose squared chord is at most 'maxChordSq'.
+		template <typename Fn>
+		void within(const double* query, double maxChordSq, size_t begin, size_t end, Fn& fn) const
+		{
+			if (end - begin <= leafSize)
+			{
+				for (size_t pos = begin; pos < end; ++pos)
+				{
+					double chordSq = squaredChord(query, pos);
+					if (chordSq <= maxChordSq)
+						fn(pos, chordSq);
+				}
+				return;
+			}
+
+			size_t mid = begin + (end - begin) / 2;
+			double diff = query[axes[mid]] - xyz[mid * 3 + axes[mid]];
+			double chordSq = squaredChord(query, mid);
+			if (chordSq <= maxChordSq)
+				fn(mid, chordSq);
+			if ((diff <= (double)0.0) || (diff * diff <= maxChordSq))
+				within(query, maxChordSq, begin, mid, fn);
+			if ((diff >= (double)0.0) || (diff * diff <= maxChordSq))
+				within(query, maxChordSq, mid + 1, end, fn);
+		}
+	};
+	}
+
+	GeoIndex::GeoIndex() :
+		m_buffer(NULL),
+		m_bufferLen(0),
+		m_numPoints(0),
+		m_xyz(NULL),
+		m_ids(NULL),
+		m_axes(NULL)
+	{
+	}
+
+	GeoIndex::~GeoIndex(void)
+	{
+	}
+
+	void GeoIndex::clear(void)
+	{
+		m_storage.clear();
+		m_buffer = NULL;
+		m_bufferLen = 0;
+		m_numPoints = 0;
+		m_xyz = NULL;
+		m_ids = NULL;
+		m_axes = NULL;
+	}
+
+	bool GeoIndex::setPointers(const uint8_t* buffer, size_t bufferLen)
+	{
+		const uint64_t* header = (const uint64_t*)buffer;
+		size_t numPoints = (size_t)header[1];
+
+		if ((header[0] != MAGIC) || (header[2] != LEAF_SIZE) || (numPoints > bufferLen / 32) || (bufferSize(numPoints) > bufferLen))
+		{
+			return false;
+		}
+
+		// The queries index the unit vectors by split axis, so a foreign or corrupted buffer must not get past here.
+		const uint8_t* axes = (const uint8_t*)(header + HEADER_WORDS + 4 * numPoints);
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			if (axes[i] >= 3)
+				return false;
+		}
+
+		m_buffer = buffer;
+		m_bufferLen = bufferSize(numPoints);
+		m_numPoints = numPoints;
+		m_xyz = (const double*)(header + HEADER_WORDS);
+		m_ids = header + HEADER_WORDS + 3 * numPoints;
+		m_axes = axes;
+		return true;
+	}
+
+	bool GeoIndex::build(const double* lat, const double* lon, size_t numPoints)
+	{
+		const size_t MIN_POINTS_PER_THREAD = 8192;
+
+		clear();
+
+		// Sanity check.
+		if ((lat == NULL) || (lon == NULL))
+		{
+			return false;
+		}
+
+		m_storage.assign(bufferSize(numPoints) / sizeof(uint64_t), 0);
+		uint64_t* header = m_storage.data();
+		header[0] = MAGIC;
+		header[1] = numPoints;
+		header[2] = LEAF_SIZE;
+		double* xyz = (double*)(header + HEADER_WORDS);
+		uint64_t* ids = header + HEADER_WORDS + 3 * numPoints;
+		uint8_t* axes = (uint8_t*)(header + HEADER_WORDS + 4 * numPoints);
+
+		std::vector<double> points(numPoints * 3);
+		std::vector<size_t> order(numPoints);
+		Parallel::forRange(numPoints, MIN_POINTS_PER_THREAD, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				Distance::toUnitVector(lat[i], lon[i], points.data() + i * 3);
+				order[i] = i;
+			}
+		});
+
+		// Enough parallel levels to give every thread a subtree.
+		size_t parallelDepth = 0;
+		while (((size_t)1 << parallelDepth) < Parallel::numThreads())
+			++parallelDepth;
+		buildRange(points.data(), order.data(), axes, 0, numPoints, parallelDepth);
+
+		// Lay the points out in tree order.
+		Parallel::forRange(numPoints, MIN_POINTS_PER_THREAD, [&](size_t begin, size_t end) {
+			for (size_t pos = begin; pos < end; ++pos)
+			{
+				memcpy(xyz + pos * 3, points.data() + order[pos] * 3, 3 * sizeof(double));
+				ids[pos] = order[pos];
+			}
+		});
+
+		return setPointers((const uint8_t*)m_storage.data(), m_storage.size() * sizeof(uint64_t));
+	}
+
+	bool GeoIndex::attach(const void* buffer, size_t bufferLen)
+	{
+		clear();
+
+		// Sanity check.
+		if ((buffer == NULL) || (bufferLen < HEADER_WORDS * sizeof(uint64_t)) || ((uintptr_t)buffer % sizeof(uint64_t) != 0))
+		{
+			return false;
+		}
+		return setPointers((const uint8_t*)buffer, bufferLen);
+	}
+
+	bool GeoIndex::serialize(void* buffer, size_t bufferLen) const
+	{
+		// Sanity check.
+		if ((buffer == NULL) || (m_buffer == NULL) || (bufferLen < m_bufferLen))
+		{
+			return false;
+		}
+
+		memcpy(buffer, m_buffer, m_bufferLen);
+		return true;
+	}
+
+	size_t GeoIndex::nearest(double lat, double lon, size_t k, size_t* indices, double* distances) const
+	{
+		// Sanity check.
+		if ((m_numPoints == 0) || (k == 0) || (indices == NULL))
+		{
+			return 0;
+		}
+
+		double query[3];
+		Distance::toUnitVector(lat, lon, query);
+
+		TreeView tree = { m_xyz, m_ids, m_axes, (size_t)((const uint64_t*)m_buffer)[2] };
+		std::vector<std::pair<double, size_t> > heap;
+		heap.reserve(std::min(k, m_numPoints));
+		tree.nearest(query, k, 0, m_numPoints, heap);
+		std::sort_heap(heap.begin(), heap.end());
+
+		for (size_t i = 0; i < heap.size(); ++i)
+		{
+			indices[i] = (size_t)m_ids[heap[i].second];
+			if (distances)
+				distances[i] = chordToMeters(heap[i].first);
+		}
+		return heap.size();
+	}
+
+	size_t GeoIndex::withinRadius(double lat, double lon, double radiusMeters, std::vector<size_t>& indices, std::vector<double>* distances) const
+	{
+		// Sanity check.
+		if ((m_numPoints == 0) || !(radiusMeters >= (double)0.0))
+		{
+			return 0;
+		}
+
+		double query[3];
+		Distance::toUnitVector(lat, lon, query);
+
+		// A great circle distance of r is a chord of 2 sin(r / 2R) on the unit sphere. Pad it slightly so rounding can't
+		// drop a point on the boundary; the exact test is on the distance in meters.
+		double angle = radiusMeters / Distance::EARTH_RADIUS;
+		double chord = (angle < PI) ? (double)2.0 * sin((double)0.5 * angle) : (double)2.0;
+		double maxChordSq = chord * chord * (double)1.000001 + (double)1e-18;
+
+		size_t numFound = 0;
+		auto visit = [&](size_t pos, double chordSq) {
+			double meters = chordToMeters(chordSq);
+			if (meters <= radiusMeters)
+			{
+				indices.push_back((size_t)m_ids[pos]);
+				if (distances)
+					distances->push_back(meters);
+				++numFound;
+			}
+		};
+		TreeView tree = { m_xyz, m_ids, m_axes, (size_t)((const uint64_t*)m_buffer)[2] };
+		tree.within(query, maxChordSq, 0, m_numPoints, visit);
+		return numFound;
+	}
+}
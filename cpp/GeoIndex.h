@@ -0,0 +1,105 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _GEOINDEX_
+#define _GEOINDEX_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace LibMath
+{
+	/**
+	 * Static spatial index over latitude/longitude points, for "nearest known location" and "everything within R meters"
+	 * queries. Points are stored as 3D unit vectors in an implicit k-d tree (median splits, no node pointers), so there
+	 * are no special cases at the poles or the antimeridian. Distances are great circle distances on the same sphere as
+	 * Distance::haversineDistance (at zero altitude).
+	 *
+	 * The whole index lives in one flat buffer: a header, the unit vectors, the original point indices, and one split axis
+	 * per node. That buffer can be written out with serialize() and later used in place (memory mapped, for example) with
+	 * attach(). The buffer uses the native byte order.
+	 */
+	class GeoIndex
+	{
+	public:
+		GeoIndex();
+		virtual ~GeoIndex(void);
+
+		/**
+		 * Builds the index over 'numPoints' points (degrees). The top levels of the tree are built in parallel.
+		 * Query results refer to points by their position in these arrays.
+		 */
+		bool build(const double* lat, const double* lon, size_t numPoints);
+
+		/**
+		 * Uses a buffer produced by serialize() in place, without copying it. The buffer must be 8 byte aligned and must
+		 * outlive this object (or the next call to build/attach). Returns FALSE if the buffer doesn't hold a valid index.
+		 */
+		bool attach(const void* buffer, size_t bufferLen);
+
+		/**
+		 * Returns the number of bytes needed by serialize().
+		 */
+		size_t serializedSize(void) const { return m_bufferLen; }
+
+		/**
+		 * Copies the index to 'buffer'. Returns FALSE if the buffer is too small.
+		 */
+		bool serialize(void* buffer, size_t bufferLen) const;
+
+		/**
+		 * Returns the number of points in the index.
+		 */
+		size_t size(void) const { return m_numPoints; }
+
+		/**
+		 * Finds the (up to) k points closest to the given location, closest first. Writes their indices to 'indices' and,
+		 * if not NULL, their distances in meters to 'distances'. Returns the number of points found.
+		 */
+		size_t nearest(double lat, double lon, size_t k, size_t* indices, double* distances) const;
+
+		/**
+		 * Finds every point within 'radiusMeters' of the given location, in no particular order. Appends their indices to
+		 * 'indices' and, if not NULL, their distances in meters to 'distances'. Returns the number of points found.
+		 */
+		size_t withinRadius(double lat, double lon, double radiusMeters, std::vector<size_t>& indices, std::vector<double>* distances = NULL) const;
+
+	private:
+		std::vector<uint64_t> m_storage;    // owned buffer, when built rather than attached
+		const uint8_t*        m_buffer;
+		size_t                m_bufferLen;
+		size_t                m_numPoints;
+		const double*         m_xyz;        // unit vectors, in tree order
+		const uint64_t*       m_ids;        // original index of each point, in tree order
+		const uint8_t*        m_axes;       // split axis of the node at each position
+
+		void clear(void);
+		bool setPointers(const uint8_t* buffer, size_t bufferLen);
+
+		GeoIndex(const GeoIndex&);
+		GeoIndex& operator=(const GeoIndex&);
+	};
+}
+
+#endif
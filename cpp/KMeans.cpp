@@ -21,12 +21,197 @@
 
 #include "KMeans.h"
 #include "Distance.h"
+#include "Parallel.h"
 #include "Statistics.h"
 
+#include <algorithm>
+#include <math.h>
 #include <string.h>
+#include <vector>
 
 namespace LibMath
 {
+	static inline double squaredDistance(const double* pt1, const double* pt2, size_t dimensions)
+	{
+		double sum = (double)0.0;
+
+		for (size_t i = 0; i < dimensions; ++i)
+		{
+			double diff = pt1[i] - pt2[i];
+			sum += diff * diff;
+		}
+		return sum;
+	}
+
+	/// Returns the index of the centroid closest to 'point', and the squared distance to it.
+	static inline size_t nearestCentroid(const double* point, const double* centroids, size_t k, size_t dimensions, double* distance)
+	{
+		size_t bestIndex = 0;
+		double bestDistance = squaredDistance(point, centroids, dimensions);
+
+		for (size_t clusterIndex = 1; clusterIndex < k; ++clusterIndex)
+		{
+			double temp = squaredDistance(point, centroids + clusterIndex * dimensions, dimensions);
+			if (temp < bestDistance)
+			{
+				bestIndex = clusterIndex;
+				bestDistance = temp;
+			}
+		}
+		*distance = bestDistance;
+		return bestIndex;
+	}
+
+	/// Assigns each point to a cluster by counting how many of the (sorted) centroid midpoints it lies above,
+	/// which is the same as picking the nearest centroid, with ties going to the lower index.
+	/// Returns the number of points that changed cluster.
+	template <size_t K>
+	static size_t assignSortedCentroids(const double* data, size_t dataLen, const double* midpoints, size_t* tags)
+	{
+		size_t numRelocations = 0;
+
+		for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+		{
+			size_t tag = 0;
+			for (size_t i = 0; i < K - 1; ++i)
+				tag += (data[dataIndex] > midpoints[i]) ? 1 : 0;
+			numRelocations += (tag != tags[dataIndex]) ? 1 : 0;
+			tags[dataIndex] = tag;
+		}
+		return numRelocations;
+	}
+
+	static size_t assignSortedCentroids(const double* data, size_t dataLen, size_t k, const double* midpoints, size_t* tags)
+	{
+		switch (k)
+		{
+		case 2: return assignSortedCentroids<2>(data, dataLen, midpoints, tags);
+		case 3: return assignSortedCentroids<3>(data, dataLen, midpoints, tags);
+		case 4: return assignSortedCentroids<4>(data, dataLen, midpoints, tags);
+		case 5: return assignSortedCentroids<5>(data, dataLen, midpoints, tags);
+		case 6: return assignSortedCentroids<6>(data, dataLen, midpoints, tags);
+		case 7: return assignSortedCentroids<7>(data, dataLen, midpoints, tags);
+		case 8: return assignSortedCentroids<8>(data, dataLen, midpoints, tags);
+		default:
+			break;
+		}
+
+		size_t numRelocations = 0;
+		for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+		{
+			size_t tag = 0;
+			for (size_t i = 0; i < k - 1; ++i)
+				tag += (data[dataIndex] > midpoints[i]) ? 1 : 0;
+			numRelocations += (tag != tags[dataIndex]) ? 1 : 0;
+			tags[dataIndex] = tag;
+		}
+		return numRelocations;
+	}
+
+	/// Clusters one series of a batch. 'scratch' holds at least 3 * k values.
+	static void kMeans1DSeries(const double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, double* centroids, double* scratch, size_t* tags)
+	{
+		double* midpoints = scratch;
+		double* sums = scratch + k;
+		double* counts = scratch + 2 * k;
+
+		// Equally spaced initial centroids. These are sorted, and 1D Lloyd's iterations keep them sorted,
+		// which is what lets the assignment step use the midpoints.
+		double min = Statistics::min(data, dataLen);
+		double max = Statistics::max(data, dataLen);
+		double increment = (k > 1) ? (max - min) / (double)(k - 1) : (double)0.0;
+		for (size_t clusterIndex = 0; clusterIndex < k; ++clusterIndex)
+			centroids[clusterIndex] = min + (increment * (double)clusterIndex);
+		if (k == 1)
+			centroids[0] = Statistics::averageDouble(data, dataLen);
+
+		for (size_t i = 0; i + 1 < k; ++i)
+			midpoints[i] = (double)0.5 * (centroids[i] + centroids[i + 1]);
+		memset(tags, 0, sizeof(size_t) * dataLen);
+		if (k == 1)
+			return;
+		assignSortedCentroids(data, dataLen, k, midpoints, tags);
+
+		size_t iterCount = 0;
+		size_t numRelocations = 0;
+		double avgError = (double)0.0;
+		do {
+			// Recompute cluster means. An empty cluster keeps its previous centroid.
+			memset(sums, 0, sizeof(double) * k);
+			memset(counts, 0, sizeof(double) * k);
+			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+			{
+				sums[tags[dataIndex]] += data[dataIndex];
+				counts[tags[dataIndex]] += (double)1.0;
+			}
+			for (size_t clusterIndex = 0; clusterIndex < k; ++clusterIndex)
+			{
+				if (counts[clusterIndex] > (double)0.0)
+					centroids[clusterIndex] = sums[clusterIndex] / counts[clusterIndex];
+			}
+			for (size_t i = 0; i + 1 < k; ++i)
+				midpoints[i] = (double)0.5 * (centroids[i] + centroids[i + 1]);
+
+			// Relocate each data point to the cluster that matches best.
+			numRelocations = assignSortedCentroids(data, dataLen, k, midpoints, tags);
+
+			// Compute the average error.
+			double totalError = (double)0.0;
+			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+				totalError += fabs(data[dataIndex] - centroids[tags[dataIndex]]);
+			avgError = totalError / (double)dataLen;
+
+			++iterCount;
+		} while ((avgError > maxError) && (iterCount < maxIters) && (numRelocations > 0));
+	}
+
+	KMeansWorkspace::KMeansWorkspace()
+	{
+		m_errors = NULL;
+		m_distances = NULL;
+		m_pointCapacity = 0;
+		m_clusterSizes = NULL;
+		m_clusterCapacity = 0;
+		m_sums = NULL;
+		m_centroids = NULL;
+		m_centroidCapacity = 0;
+	}
+
+	KMeansWorkspace::~KMeansWorkspace(void)
+	{
+		delete[] m_errors;
+		delete[] m_distances;
+		delete[] m_clusterSizes;
+		delete[] m_sums;
+		delete[] m_centroids;
+	}
+
+	void KMeansWorkspace::reserve(size_t dataLen, size_t k, size_t dimensions)
+	{
+		if (dataLen > m_pointCapacity)
+		{
+			delete[] m_errors;
+			delete[] m_distances;
+			m_errors = new double[dataLen];
+			m_distances = new double[dataLen];
+			m_pointCapacity = dataLen;
+		}
+		if (k > m_clusterCapacity)
+		{
+			delete[] m_clusterSizes;
+			m_clusterSizes = new size_t[k];
+			m_clusterCapacity = k;
+		}
+		if (k * dimensions > m_centroidCapacity)
+		{
+			delete[] m_sums;
+			delete[] m_centroids;
+			m_sums = new double[k * dimensions];
+			m_centroids = new double[k * dimensions];
+			m_centroidCapacity = k * dimensions;
+		}
+	}
+
 	size_t* KMeans::kMeans1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, double* centroids)
 	{
 		// Sanity check.
@@ -35,30 +220,36 @@ namespace LibMath
 			return NULL;
 		}
 
-		// Create the output error array; describes the error for each data point.
-		double* errors = (double*)new double[dataLen];
-		if (!errors)
+		// Create the output tag array.
+		size_t* tags = (size_t*)new size_t[dataLen];
+		if (!tags)
 		{
 			return NULL;
 		}
 
-		// Create the cluster means array; describes the error for each data point.
-		size_t* clusterSizes = (size_t*)new size_t[k];
-		if (!clusterSizes)
+		KMeansWorkspace workspace;
+		if (!kMeans1D(data, dataLen, k, maxError, maxIters, centroids, tags, workspace))
 		{
-			delete[] errors;
+			delete[] tags;
 			return NULL;
 		}
+		return tags;
+	}
 
-		// Create the output tag array.
-		size_t* tags = (size_t*)new size_t[dataLen];
-		if (!tags)
+	bool KMeans::kMeans1D(const double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, double* centroids, size_t* tags, KMeansWorkspace& workspace)
+	{
+		// Sanity check.
+		if (k == 0)
 		{
-			delete[] clusterSizes;
-			delete[] errors;
-			return NULL;
+			return false;
 		}
 
+		// The error array describes the error for each data point.
+		workspace.reserve(dataLen, k, 1);
+		double* errors = workspace.m_errors;
+		size_t* clusterSizes = workspace.m_clusterSizes;
+		double* sums = workspace.m_sums;
+
 		// Assignment step. Find the closest centroid for each data point.
 		for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
 		{
@@ -78,18 +269,21 @@ namespace LibMath
 		size_t iterCount = 0;
 		size_t numRelocations = 0;
 		do {
-			// Recompute cluster means.
-			memset(centroids, 0, sizeof(double) * k);
+			// Recompute cluster means. An empty cluster keeps its previous centroid.
+			memset(sums, 0, sizeof(double) * k);
 			memset(clusterSizes, 0, sizeof(size_t) * k);
 			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
 			{
 				size_t clusterIndex = tags[dataIndex];
-				centroids[clusterIndex] += data[dataIndex];
+				sums[clusterIndex] += data[dataIndex];
 				clusterSizes[clusterIndex]++;
 			}
 			for (size_t clusterIndex = 0; clusterIndex < k; ++clusterIndex)
 			{
-				centroids[clusterIndex] /= clusterSizes[clusterIndex];
+				if (clusterSizes[clusterIndex] > 0)
+				{
+					centroids[clusterIndex] = sums[clusterIndex] / (double)clusterSizes[clusterIndex];
+				}
 			}
 
 			// Measure each data point against it's own cluster mean, and all other cluster means.
@@ -97,6 +291,9 @@ namespace LibMath
 			numRelocations = 0;
 			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
 			{
+				size_t ownCluster = tags[dataIndex];
+				errors[dataIndex] = Distance::euclidianDistance1D(data[dataIndex], centroids[ownCluster]);
+
 				for (size_t clusterIndex = 0; clusterIndex < k; ++clusterIndex)
 				{
 					double distance = Distance::euclidianDistance1D(data[dataIndex], centroids[clusterIndex]);
@@ -104,9 +301,12 @@ namespace LibMath
 					{
 						tags[dataIndex] = clusterIndex;
 						errors[dataIndex] = distance;
-						++numRelocations;
 					}
 				}
+				if (tags[dataIndex] != ownCluster)
+				{
+					++numRelocations;
+				}
 			}
 
 			// Compute the average error.
@@ -115,17 +315,13 @@ namespace LibMath
 			++iterCount;
 		} while ((avgError > maxError) && (iterCount < maxIters) && (numRelocations > 0));
 
-		// Free memory.
-		delete[] clusterSizes;
-		delete[] errors;
-
-		return tags;
+		return true;
 	}
 
 	size_t* KMeans::withEquallySpacedCentroids1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters)
 	{
 		// Sanity check.
-		if (dataLen <= 1)
+		if ((dataLen <= 1) || (k == 0))
 		{
 			return NULL;
 		}
@@ -135,15 +331,24 @@ namespace LibMath
 		double* centroids = (double*)new double[k];
 		if (centroids)
 		{
+			// A single cluster is just the mean.
+			if (k == 1)
+			{
+				centroids[0] = Statistics::averageDouble(data, dataLen);
+			}
+
 			// Select the k data points that are farthest apart from each other.
-			double min = Statistics::min(data, dataLen);
-			centroids[0] = min;
-			double max = Statistics::max(data, dataLen);
-			centroids[k - 1] = max;
-			double increment = (max - min) / (double)(k - 1);
-			for (size_t i = 1; i < k - 1; ++i)
+			else
 			{
-				centroids[i] = min + (increment * (double)i);
+				double min = Statistics::min(data, dataLen);
+				centroids[0] = min;
+				double max = Statistics::max(data, dataLen);
+				centroids[k - 1] = max;
+				double increment = (max - min) / (double)(k - 1);
+				for (size_t i = 1; i < k - 1; ++i)
+				{
+					centroids[i] = min + (increment * (double)i);
+				}
 			}
 
 			// Perform K Means clustering.
@@ -156,10 +361,10 @@ namespace LibMath
 		return tags;
 	}
 
-	size_t* KMeans::withRandCentroids1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters)
+	size_t* KMeans::withRandCentroids1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, uint64_t seed)
 	{
 		// Sanity check.
-		if (dataLen <= 1)
+		if ((dataLen <= 1) || (k == 0) || (k > dataLen))
 		{
 			return NULL;
 		}
@@ -167,23 +372,426 @@ namespace LibMath
 		size_t* tags = NULL;
 
 		double* centroids = (double*)new double[k];
-		if (centroids)
+		size_t* selected = (size_t*)new size_t[k];
+		if (centroids && selected)
 		{
-			// Randomly select starting centroids.
+			// Randomly select k distinct data points as the starting centroids.
+			Random rng(seed);
 			for (size_t i = 0; i < k; ++i)
 			{
-				size_t selected = rand() % k;
-				centroids[i] = data[selected];
+				bool duplicate = false;
+				do {
+					selected[i] = rng.nextIndex(dataLen);
+					duplicate = false;
+					for (size_t j = 0; j < i && !duplicate; ++j)
+						duplicate = (selected[j] == selected[i]);
+				} while (duplicate);
+				centroids[i] = data[selected[i]];
 			}
 
 			// Perform K Means clustering.
 			tags = kMeans1D(data, dataLen, k, maxError, maxIters, centroids);
+		}
 
-			// Clean up.
+		// Clean up.
+		delete[] selected;
+		delete[] centroids;
+
+		return tags;
+	}
+
+	size_t* KMeans::withKMeansPlusPlusCentroids1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, uint64_t seed)
+	{
+		size_t* tags = NULL;
+
+		double* centroids = (double*)new double[k];
+		if (centroids)
+		{
+			Random rng(seed);
+			if (kMeansPlusPlusCentroids(data, NULL, dataLen, 1, k, rng, centroids))
+			{
+				tags = kMeans1D(data, dataLen, k, maxError, maxIters, centroids);
+			}
+			delete[] centroids;
+		}
+		return tags;
+	}
+
+	size_t* KMeans::withKMeansParallelCentroids1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, uint64_t seed)
+	{
+		size_t* tags = NULL;
+
+		double* centroids = (double*)new double[k];
+		if (centroids)
+		{
+			Random rng(seed);
+			if (kMeansParallelCentroids(data, dataLen, 1, k, rng, centroids))
+			{
+				tags = kMeans1D(data, dataLen, k, maxError, maxIters, centroids);
+			}
+			delete[] centroids;
+		}
+		return tags;
+	}
+
+	bool KMeans::kMeans1DBatch(const double* values, const size_t* offsets, size_t numSeries, size_t k, double maxError, size_t maxIters, size_t* tags, double* centroids)
+	{
+		const size_t MIN_SERIES_PER_THREAD = 256;
+
+		// Sanity check.
+		if (k == 0)
+		{
+			return false;
+		}
+
+		Parallel::forRange(numSeries, MIN_SERIES_PER_THREAD, [&](size_t begin, size_t end) {
+			// One set of scratch buffers per thread, rather than per series.
+			std::vector<double> scratch(4 * k);
+			double* seriesCentroids = scratch.data() + 3 * k;
+
+			for (size_t seriesIndex = begin; seriesIndex < end; ++seriesIndex)
+			{
+				size_t seriesStart = offsets[seriesIndex];
+				size_t seriesLen = offsets[seriesIndex + 1] - seriesStart;
+				double* outCentroids = centroids ? centroids + seriesIndex * k : seriesCentroids;
+
+				if (seriesLen == 0)
+				{
+					if (centroids)
+						memset(outCentroids, 0, sizeof(double) * k);
+					continue;
+				}
+				kMeans1DSeries(values + seriesStart, seriesLen, k, maxError, maxIters, outCentroids, scratch.data(), tags + seriesStart);
+			}
+		});
+		return true;
+	}
+
+	size_t* KMeans::kMeansND(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, double* centroids)
+	{
+		// Sanity check.
+		if ((k == 0) || (dimensions == 0))
+		{
+			return NULL;
+		}
+
+		size_t* tags = (size_t*)new size_t[dataLen];
+		KMeansWorkspace workspace;
+		if (!kMeansND(data, dataLen, dimensions, k, maxError, maxIters, centroids, tags, workspace))
+		{
+			delete[] tags;
+			return NULL;
+		}
+		return tags;
+	}
+
+	bool KMeans::kMeansND(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, double* centroids, size_t* tags, KMeansWorkspace& workspace)
+	{
+		// Sanity check.
+		if ((k == 0) || (dimensions == 0))
+		{
+			return false;
+		}
+
+		workspace.reserve(dataLen, k, dimensions);
+		double* errors = workspace.m_errors;
+		size_t* clusterSizes = workspace.m_clusterSizes;
+		double* sums = workspace.m_sums;
+
+		// Assignment step. Find the closest centroid for each data point.
+		for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+		{
+			tags[dataIndex] = nearestCentroid(data + dataIndex * dimensions, centroids, k, dimensions, &errors[dataIndex]);
+			errors[dataIndex] = sqrt(errors[dataIndex]);
+		}
+
+		// Update step.
+		double avgError = (double)0.0;
+		size_t iterCount = 0;
+		size_t numRelocations = 0;
+		do {
+			// Recompute cluster means. An empty cluster keeps its previous centroid.
+			memset(sums, 0, sizeof(double) * k * dimensions);
+			memset(clusterSizes, 0, sizeof(size_t) * k);
+			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+			{
+				size_t clusterIndex = tags[dataIndex];
+				double* sum = sums + clusterIndex * dimensions;
+				const double* point = data + dataIndex * dimensions;
+				for (size_t i = 0; i < dimensions; ++i)
+				{
+					sum[i] += point[i];
+				}
+				clusterSizes[clusterIndex]++;
+			}
+			for (size_t clusterIndex = 0; clusterIndex < k; ++clusterIndex)
+			{
+				if (clusterSizes[clusterIndex] > 0)
+				{
+					double* centroid = centroids + clusterIndex * dimensions;
+					const double* sum = sums + clusterIndex * dimensions;
+					for (size_t i = 0; i < dimensions; ++i)
+					{
+						centroid[i] = sum[i] / (double)clusterSizes[clusterIndex];
+					}
+				}
+			}
+
+			// Relocate each data point to the cluster that matches best.
+			numRelocations = 0;
+			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+			{
+				size_t clusterIndex = nearestCentroid(data + dataIndex * dimensions, centroids, k, dimensions, &errors[dataIndex]);
+				errors[dataIndex] = sqrt(errors[dataIndex]);
+				if (clusterIndex != tags[dataIndex])
+				{
+					tags[dataIndex] = clusterIndex;
+					++numRelocations;
+				}
+			}
+
+			// Compute the average error.
+			avgError = Statistics::averageDouble(errors, dataLen);
+
+			++iterCount;
+		} while ((avgError > maxError) && (iterCount < maxIters) && (numRelocations > 0));
+
+		return true;
+	}
+
+	size_t* KMeans::withKMeansPlusPlusCentroidsND(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, uint64_t seed)
+	{
+		size_t* tags = NULL;
+
+		double* centroids = (double*)new double[k * dimensions];
+		if (centroids)
+		{
+			Random rng(seed);
+			if (kMeansPlusPlusCentroids(data, NULL, dataLen, dimensions, k, rng, centroids))
+			{
+				tags = kMeansND(data, dataLen, dimensions, k, maxError, maxIters, centroids);
+			}
 			delete[] centroids;
 		}
-		
 		return tags;
 	}
+
+	size_t* KMeans::withKMeansParallelCentroidsND(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, uint64_t seed)
+	{
+		size_t* tags = NULL;
+
+		double* centroids = (double*)new double[k * dimensions];
+		if (centroids)
+		{
+			Random rng(seed);
+			if (kMeansParallelCentroids(data, dataLen, dimensions, k, rng, centroids))
+			{
+				tags = kMeansND(data, dataLen, dimensions, k, maxError, maxIters, centroids);
+			}
+			delete[] centroids;
+		}
+		return tags;
+	}
+
+	bool KMeans::withKMeansPlusPlusCentroids(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, Random& rng, size_t* tags, KMeansWorkspace& workspace)
+	{
+		workspace.reserve(dataLen, k, dimensions);
+		if (!kMeansPlusPlusCentroids(data, NULL, dataLen, dimensions, k, rng, workspace.m_centroids, workspace))
+		{
+			return false;
+		}
+		if (dimensions == 1)
+		{
+			return kMeans1D(data, dataLen, k, maxError, maxIters, workspace.m_centroids, tags, workspace);
+		}
+		return kMeansND(data, dataLen, dimensions, k, maxError, maxIters, workspace.m_centroids, tags, workspace);
+	}
+
+	bool KMeans::kMeansPlusPlusCentroids(const double* data, const double* weights, size_t dataLen, size_t dimensions, size_t k, Random& rng, double* centroids)
+	{
+		KMeansWorkspace workspace;
+		return kMeansPlusPlusCentroids(data, weights, dataLen, dimensions, k, rng, centroids, workspace);
+	}
+
+	bool KMeans::kMeansPlusPlusCentroids(const double* data, const double* weights, size_t dataLen, size_t dimensions, size_t k, Random& rng, double* centroids, KMeansWorkspace& workspace)
+	{
+		// Sanity check.
+		if ((k == 0) || (dimensions == 0) || (dataLen < k))
+		{
+			return false;
+		}
+
+		// Squared distance from each point to the closest centroid chosen so far.
+		workspace.reserve(dataLen, k, dimensions);
+		double* minDistances = workspace.m_distances;
+
+		// The first centroid is chosen at random (in proportion to weight, if weighted).
+		size_t selected = rng.nextIndex(dataLen);
+		if (weights)
+		{
+			double totalWeight = (double)0.0;
+			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+				totalWeight += weights[dataIndex];
+
+			double target = rng.nextDouble() * totalWeight;
+			for (selected = 0; selected < dataLen - 1; ++selected)
+			{
+				target -= weights[selected];
+				if (target < (double)0.0)
+					break;
+			}
+		}
+		memcpy(centroids, data + selected * dimensions, sizeof(double) * dimensions);
+
+		for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+		{
+			minDistances[dataIndex] = squaredDistance(data + dataIndex * dimensions, centroids, dimensions);
+		}
+
+		// Each remaining centroid is chosen with probability proportional to D(x)^2.
+		for (size_t clusterIndex = 1; clusterIndex < k; ++clusterIndex)
+		{
+			double total = (double)0.0;
+			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+				total += minDistances[dataIndex] * (weights ? weights[dataIndex] : (double)1.0);
+
+			// Every point sits on a centroid already, so any choice is as good as another.
+			if (total <= (double)0.0)
+			{
+				selected = rng.nextIndex(dataLen);
+			}
+			else
+			{
+				double target = rng.nextDouble() * total;
+				for (selected = 0; selected < dataLen - 1; ++selected)
+				{
+					target -= minDistances[selected] * (weights ? weights[selected] : (double)1.0);
+					if (target < (double)0.0)
+						break;
+				}
+			}
+
+			double* centroid = centroids + clusterIndex * dimensions;
+			memcpy(centroid, data + selected * dimensions, sizeof(double) * dimensions);
+
+			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+			{
+				double distance = squaredDistance(data + dataIndex * dimensions, centroid, dimensions);
+				if (distance < minDistances[dataIndex])
+					minDistances[dataIndex] = distance;
+			}
+		}
+
+		return true;
+	}
+
+	bool KMeans::kMeansParallelCentroids(const double* data, size_t dataLen, size_t dimensions, size_t k, Random& rng, double* centroids, double oversampling, size_t rounds)
+	{
+		const size_t MIN_POINTS_PER_THREAD = 4096;
+		const size_t NUM_REFINEMENT_ITERS = 10;
+
+		// Sanity check.
+		if ((k == 0) || (dimensions == 0) || (dataLen < k))
+		{
+			return false;
+		}
+
+		std::vector<double> candidates;
+		std::vector<size_t> nearest(dataLen, 0);
+		std::vector<double> minDistances(dataLen, (double)0.0);
+
+		// Start with a single, uniformly chosen, candidate.
+		size_t selected = rng.nextIndex(dataLen);
+		candidates.insert(candidates.end(), data + selected * dimensions, data + (selected + 1) * dimensions);
+		Parallel::forRange(dataLen, MIN_POINTS_PER_THREAD, [&](size_t begin, size_t end) {
+			for (size_t dataIndex = begin; dataIndex < end; ++dataIndex)
+				minDistances[dataIndex] = squaredDistance(data + dataIndex * dimensions, candidates.data(), dimensions);
+		});
+
+		// Each round samples every point independently with probability proportional to D(x)^2,
+		// so that about 'oversampling * k' new candidates are added per round.
+		double expected = oversampling * (double)k;
+		for (size_t round = 0; round < rounds; ++round)
+		{
+			double cost = (double)0.0;
+			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+				cost += minDistances[dataIndex];
+			if (cost <= (double)0.0)
+				break;
+
+			size_t firstNew = candidates.size() / dimensions;
+			for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+			{
+				if (rng.nextDouble() * cost < expected * minDistances[dataIndex])
+				{
+					candidates.insert(candidates.end(), data + dataIndex * dimensions, data + (dataIndex + 1) * dimensions);
+				}
+			}
+			size_t numCandidates = candidates.size() / dimensions;
+
+			// Only the new candidates can bring a point closer.
+			Parallel::forRange(dataLen, MIN_POINTS_PER_THREAD, [&](size_t begin, size_t end) {
+				for (size_t dataIndex = begin; dataIndex < end; ++dataIndex)
+				{
+					const double* point = data + dataIndex * dimensions;
+					for (size_t candIndex = firstNew; candIndex < numCandidates; ++candIndex)
+					{
+						double distance = squaredDistance(point, candidates.data() + candIndex * dimensions, dimensions);
+						if (distance < minDistances[dataIndex])
+						{
+							minDistances[dataIndex] = distance;
+							nearest[dataIndex] = candIndex;
+						}
+					}
+				}
+			});
+		}
+
+		// Not enough distinct candidates, fall back to plain k-means++ over the data.
+		size_t numCandidates = candidates.size() / dimensions;
+		if (numCandidates < k)
+		{
+			return kMeansPlusPlusCentroids(data, NULL, dataLen, dimensions, k, rng, centroids);
+		}
+		if (numCandidates == k)
+		{
+			memcpy(centroids, candidates.data(), sizeof(double) * k * dimensions);
+			return true;
+		}
+
+		// Weight each candidate by the number of points closest to it, then reduce them to k centroids.
+		std::vector<double> weights(numCandidates, (double)0.0);
+		for (size_t dataIndex = 0; dataIndex < dataLen; ++dataIndex)
+			weights[nearest[dataIndex]] += (double)1.0;
+		if (!kMeansPlusPlusCentroids(candidates.data(), weights.data(), numCandidates, dimensions, k, rng, centroids))
+			return false;
+
+		// A few rounds of weighted Lloyd's over the (small) candidate set.
+		std::vector<double> sums(k * dimensions);
+		std::vector<double> totals(k);
+		for (size_t iter = 0; iter < NUM_REFINEMENT_ITERS; ++iter)
+		{
+			std::fill(sums.begin(), sums.end(), (double)0.0);
+			std::fill(totals.begin(), totals.end(), (double)0.0);
+			for (size_t candIndex = 0; candIndex < numCandidates; ++candIndex)
+			{
+				const double* candidate = candidates.data() + candIndex * dimensions;
+				double distance;
+				size_t clusterIndex = nearestCentroid(candidate, centroids, k, dimensions, &distance);
+				for (size_t i = 0; i < dimensions; ++i)
+					sums[clusterIndex * dimensions + i] += weights[candIndex] * candidate[i];
+				totals[clusterIndex] += weights[candIndex];
+			}
+			for (size_t clusterIndex = 0; clusterIndex < k; ++clusterIndex)
+			{
+				if (totals[clusterIndex] > (double)0.0)
+				{
+					for (size_t i = 0; i < dimensions; ++i)
+						centroids[clusterIndex * dimensions + i] = sums[clusterIndex * dimensions + i] / totals[clusterIndex];
+				}
+			}
+		}
+		return true;
+	}
 }
 
@@ -24,10 +24,50 @@
 #ifndef _KMEANS_
 #define _KMEANS_
 
+#include <stdint.h>
 #include <stdlib.h>
 
+#include "Random.h"
+
 namespace LibMath
 {
+	/**
+	 * Scratch buffers for K Means clustering. Keep one of these around and pass it to the workspace versions of the
+	 * KMeans functions to avoid allocating on every call; the buffers only grow when a larger problem comes along.
+	 * Not thread safe, use one workspace per thread.
+	 */
+	class KMeansWorkspace
+	{
+	public:
+		KMeansWorkspace();
+		virtual ~KMeansWorkspace(void);
+
+		/**
+		 * Grows the buffers, if necessary, to handle 'dataLen' points with k clusters of the given dimensionality.
+		 */
+		void reserve(size_t dataLen, size_t k, size_t dimensions);
+
+		/**
+		 * Centroid storage (at least k * dimensions values, after a call to reserve), for callers that don't want to manage their own.
+		 */
+		double* centroids(void) { return m_centroids; }
+
+		friend class KMeans;
+
+	private:
+		double* m_errors;
+		double* m_distances;
+		size_t  m_pointCapacity;
+		size_t* m_clusterSizes;
+		size_t  m_clusterCapacity;
+		double* m_sums;
+		double* m_centroids;
+		size_t  m_centroidCapacity;
+
+		KMeansWorkspace(const KMeansWorkspace&);
+		KMeansWorkspace& operator=(const KMeansWorkspace&);
+	};
+
 	class KMeans
 	{	
 	public:
@@ -37,6 +77,12 @@ namespace LibMath
 		 */
 		static size_t* kMeans1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, double* clusters);
 
+		/**
+		 * Performs K Means clustering on a one dimensional array, using the provided centroids.
+		 * Writes the cluster of each input to 'tags' (of length 'dataLen'). Does not allocate once the workspace is large enough.
+		 */
+		static bool kMeans1D(const double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, double* centroids, size_t* tags, KMeansWorkspace& workspace);
+
 		/**
 		 * Performs K Means clustering on a one dimensional array, setting the initial centroids to the data points farthest apart.
 		 * Returns an array of length 'dataLen', that associates each input with a given cluster. 
@@ -47,7 +93,76 @@ namespace LibMath
 		 * Performs K Means clustering on a one dimensional array, using random initial centroids.
 		 * Returns an array of length 'dataLen', that associates each input with a given cluster. 
 		 */
-		static size_t* withRandCentroids1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters);
+		static size_t* withRandCentroids1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, uint64_t seed = 0);
+
+		/**
+		 * Performs K Means clustering on a one dimensional array, using k-means++ to select the initial centroids.
+		 * Returns an array of length 'dataLen', that associates each input with a given cluster.
+		 */
+		static size_t* withKMeansPlusPlusCentroids1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, uint64_t seed = 0);
+
+		/**
+		 * Performs K Means clustering on a one dimensional array, using k-means|| to select the initial centroids.
+		 * Returns an array of length 'dataLen', that associates each input with a given cluster.
+		 */
+		static size_t* withKMeansParallelCentroids1D(double* data, size_t dataLen, size_t k, double maxError, size_t maxIters, uint64_t seed = 0);
+
+		/**
+		 * Clusters many small, independent, one dimensional series in a single call. Series i is
+		 * values[offsets[i]] .. values[offsets[i + 1] - 1], so 'offsets' has 'numSeries' + 1 entries.
+		 * Each series starts with equally spaced centroids, as in withEquallySpacedCentroids1D.
+		 * Writes the cluster of each value to the matching position in 'tags' (offsets[numSeries] entries) and, if
+		 * 'centroids' is not NULL, the k final centroids of each series to centroids[i * k] .. centroids[i * k + k - 1].
+		 * Series are spread across threads, and the assignment loop is branch free (and unrolled for k <= 8) so that it vectorizes.
+		 */
+		static bool kMeans1DBatch(const double* values, const size_t* offsets, size_t numSeries, size_t k, double maxError, size_t maxIters, size_t* tags, double* centroids = NULL);
+
+		/**
+		 * Performs K Means clustering on an array of 'dataLen' points, each with 'dimensions' values (stored row-major),
+		 * using the provided centroids (k * dimensions values, updated in place).
+		 * Returns an array of length 'dataLen', that associates each input with a given cluster.
+		 */
+		static size_t* kMeansND(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, double* centroids);
+
+		/**
+		 * Performs K Means clustering on an array of N dimensional points, using the provided centroids.
+		 * Writes the cluster of each input to 'tags' (of length 'dataLen'). Does not allocate once the workspace is large enough.
+		 */
+		static bool kMeansND(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, double* centroids, size_t* tags, KMeansWorkspace& workspace);
+
+		/**
+		 * Performs K Means clustering on an array of N dimensional points, using k-means++ to select the initial centroids.
+		 * Returns an array of length 'dataLen', that associates each input with a given cluster.
+		 */
+		static size_t* withKMeansPlusPlusCentroidsND(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, uint64_t seed = 0);
+
+		/**
+		 * Performs K Means clustering on an array of N dimensional points (use 1 for one dimensional data), using k-means++
+		 * to select the initial centroids. Writes the cluster of each input to 'tags' and leaves the final centroids in the workspace.
+		 */
+		static bool withKMeansPlusPlusCentroids(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, Random& rng, size_t* tags, KMeansWorkspace& workspace);
+
+		/**
+		 * Performs K Means clustering on an array of N dimensional points, using k-means|| to select the initial centroids.
+		 * Returns an array of length 'dataLen', that associates each input with a given cluster.
+		 */
+		static size_t* withKMeansParallelCentroidsND(const double* data, size_t dataLen, size_t dimensions, size_t k, double maxError, size_t maxIters, uint64_t seed = 0);
+
+		/**
+		 * k-means++ seeding (Arthur and Vassilvitskii, 2007). Selects k of the (optionally weighted) points as centroids,
+		 * each chosen with probability proportional to its squared distance from the centroids chosen so far.
+		 * 'weights' may be NULL. Writes k * dimensions values to 'centroids'. Returns FALSE if there are fewer than k points.
+		 */
+		static bool kMeansPlusPlusCentroids(const double* data, const double* weights, size_t dataLen, size_t dimensions, size_t k, Random& rng, double* centroids);
+		static bool kMeansPlusPlusCentroids(const double* data, const double* weights, size_t dataLen, size_t dimensions, size_t k, Random& rng, double* centroids, KMeansWorkspace& workspace);
+
+		/**
+		 * k-means|| seeding (Bahmani et al., "Scalable K-Means++", 2012). Runs a few rounds that each sample roughly
+		 * 'oversampling' * k candidates at once, instead of the k sequential passes needed by k-means++, then reduces the
+		 * weighted candidates down to k centroids with k-means++. The distance updates in each round are spread across threads.
+		 * Writes k * dimensions values to 'centroids'. Returns FALSE if there are fewer than k points.
+		 */
+		static bool kMeansParallelCentroids(const double* data, size_t dataLen, size_t dimensions, size_t k, Random& rng, double* centroids, double oversampling = 2.0, size_t rounds = 5);
 	};
 }
 
@@ -20,51 +20,130 @@
 // SOFTWARE.
 
 #include "Matrix.h"
+#include "Gemm.h"
+#include "MatrixView.h"
 
 #include <iostream>
+#include <new>
+#include <string.h>
 
 namespace LibMath
 {
+	static const size_t ALIGNMENT = 64;                                // bytes; a cache line, and an AVX-512 register
+	static const size_t ROW_ALIGNMENT = ALIGNMENT / sizeof(double);   // doubles
+
 	Matrix::Matrix()
 	{
 		m_w = 0;
 		m_h = 0;
+		m_stride = 0;
 		m_data = NULL;
 	}
 
 	Matrix::Matrix(size_t w, size_t h)
 	{
+		m_data = NULL;
+		allocate(w, h);
+	}
+
+	Matrix::Matrix(const Matrix& B)
+	{
+		m_data = NULL;
+		allocate(B.m_w, B.m_h);
+		if (m_data != NULL)
+			memcpy(m_data, B.m_data, m_w * m_stride * sizeof(double));
+	}
+
+	Matrix::Matrix(Matrix&& B)
+	{
+		m_w = B.m_w;
+		m_h = B.m_h;
+		m_stride = B.m_stride;
+		m_data = B.m_data;
+		B.m_w = 0;
+		B.m_h = 0;
+		B.m_stride = 0;
+		B.m_data = NULL;
+	}
+
+	Matrix::~Matrix()
+	{
+		release();
+	}
+
+	Matrix& Matrix::operator=(const Matrix& B)
+	{
+		if (this != &B)
+		{
+			// Reuse the storage when the shape already matches.
+			if ((m_w != B.m_w) || (m_h != B.m_h))
+				allocate(B.m_w, B.m_h);
+			if (m_data != NULL)
+				memcpy(m_data, B.m_data, m_w * m_stride * sizeof(double));
+		}
+		return *this;
+	}
+
+	Matrix& Matrix::operator=(Matrix&& B)
+	{
+		if (this != &B)
+		{
+			release();
+			m_w = B.m_w;
+			m_h = B.m_h;
+			m_stride = B.m_stride;
+			m_data = B.m_data;
+			B.m_w = 0;
+			B.m_h = 0;
+			B.m_stride = 0;
+			B.m_data = NULL;
+		}
+		return *this;
+	}
+
+	void Matrix::allocate(size_t w, size_t h)
+	{
+		release();
+
 		m_w = w;
 		m_h = h;
-		m_data = new double *[w];
-		for (auto i = 0; i < h; ++i)
-			m_data[i] = new double[h];
+		m_stride = (h + ROW_ALIGNMENT - 1) & ~(ROW_ALIGNMENT - 1);
+
+		// Padding is zeroed so that kernels reading whole aligned blocks see harmless values.
+		size_t numBytes = m_w * m_stride * sizeof(double);
+		if (numBytes > 0)
+		{
+			void* data = NULL;
+			if (posix_memalign(&data, ALIGNMENT, numBytes) != 0)
+				throw std::bad_alloc();
+			m_data = (double*)data;
+			memset(m_data, 0, numBytes);
+		}
 	}
 
-	Matrix::~Matrix()
+	void Matrix::release(void)
 	{
 		if (m_data != NULL)
 		{
-			for (auto i = 0; i < m_w; ++i)
-			{
-				delete m_data[i];
-				m_data[i] = NULL;
-			}
-			delete m_data;
+			free(m_data);
 			m_data = NULL;
 		}
+		m_w = 0;
+		m_h = 0;
+		m_stride = 0;
 	}
 
 	void Matrix::print(void)
 	{
 		if (m_data != NULL)
 		{
-			for (auto i = 0; i < m_w; ++i)
+			for (size_t i = 0; i < m_w; ++i)
 			{
+				const double* rowI = row(i);
 				std::cout << "[ ";
-				for (auto j = 0; j < m_h; ++j)
+				for (size_t j = 0; j < m_h; ++j)
 				{
-					std::cout << m_data[i][j] << " ";
+					std::cout << rowI[j] << " ";
 				}
 				std::cout << "]" << std::endl;
 			}
@@ -72,58 +151,92 @@ namespace LibMath
 		}
 	}
 
+	MatrixView Matrix::view(void)
+	{
+		return MatrixView(this);
+	}
+
+	ConstMatrixView Matrix::view(void) const
+	{
+		return ConstMatrixView(this);
+	}
+
 	void Matrix::multiply(const Matrix* B, Vector* C)
 	{
-		for (auto i = 0; i < m_w; ++i)
+		for (size_t i = 0; i < m_w; ++i)
 		{
-			for (auto j = 0; j < m_h; ++j)
+			for (size_t j = 0; j < m_h; ++j)
 			{
-				C->m_data[i] = this->m_data[i][j] * B->m_data[j][i];
+				C->m_data[i] = this->get(i, j) * B->get(j, i);
 			}
 		}
 	}
 
+	void Matrix::multiply(const Matrix* B, Matrix* C) const
+	{
+		// Sanity check.
+		if ((B->m_w != m_h) || (C->m_w != m_w) || (C->m_h != B->m_h))
+			return;
+
+		Gemm::multiply(false, false, m_w, B->m_h, m_h, (double)1.0, m_data, m_stride, B->m_data, B->m_stride, (double)0.0, C->m_data, C->m_stride);
+	}
+
 	void Matrix::multiply(double B)
 	{
-		for (auto i = 0; i < m_w; ++i)
+		for (size_t i = 0; i < m_w; ++i)
 		{
-			for (auto j = 0; j < m_h; ++j)
+			double* rowI = row(i);
+			for (size_t j = 0; j < m_h; ++j)
 			{
-				m_data[i][j] *= B;
+				rowI[j] *= B;
 			}
 		}
 	}
 
 	void Matrix::subtract(const Matrix* B, Matrix* C)
 	{
-		for (auto i = 0; i < m_w; ++i)
-		{
-			for (auto j = 0; j < m_h; ++j)
-			{
-				C->m_data[i][j] = this->m_data[i][j] - B->m_data[i][j];
-			}
-		}
+		LibMath::subtract(view(), B->view(), C->view());
 	}
 
 	void Matrix::subtract(double B)
 	{
-		for (auto i = 0; i < m_w; ++i)
+		for (size_t i = 0; i < m_w; ++i)
 		{
-			for (auto j = 0; j < m_h; ++j)
+			double* rowI = row(i);
+			for (size_t j = 0; j < m_h; ++j)
 			{
-				m_data[i][j] -= B;
+				rowI[j] -= B;
 			}
 		}
 	}
 
 	void Matrix::zero(void)
 	{
-		for (auto i = 0; i < m_w; ++i)
+		if (m_data != NULL)
 		{
-			for (auto j = 0; j < m_h; ++j)
-			{
-				m_data[i][j] = 0.0;
-			}
+			memset(m_data, 0, m_w * m_stride * sizeof(double));
 		}
 	}
+
+	Matrix operator*(const Matrix& A, const Matrix& B)
+	{
+		// Sanity check.
+		if (A.height() != B.width())
+			return Matrix();
+
+		Matrix C(A.width(), B.height());
+		A.multiply(&B, &C);
+		return C;
+	}
+
+	Vector operator*(const Matrix& A, const Vector& v)
+	{
+		// Sanity check.
+		if (A.height() != v.size())
+			return Vector();
+
+		Vector C(A.width());
+		Gemm::multiplyVector(false, A.width(), A.height(), (double)1.0, A.row(0), A.stride(), v.m_data, (double)0.0, C.m_data);
+		return C;
+	}
 }
@@ -25,16 +25,43 @@
 #define _MATRIX_
 
 #include <stdlib.h>
+#include "Expression.h"
 #include "Vector.h"
 
 namespace LibMath
 {
+	template <typename T> class BasicMatrixView;
+
 	class Matrix
 	{
 	public:
+		/**
+		 * An empty, 0 x 0 matrix.
+		 */
+		Matrix();
 		Matrix(size_t w, size_t h);
+
+		/**
+		 * Copies are deep; moves take the other matrix's storage in O(1) and leave it empty.
+		 */
+		Matrix(const Matrix& B);
+		Matrix(Matrix&& B);
+
+		/**
+		 * Allocates a matrix of the expression's dimensions and evaluates the expression into it (see Expression.h).
+		 */
+		template <typename E>
+		Matrix(const Expression<E>& expression) : m_w(0), m_h(0), m_stride(0), m_data(NULL)
+		{
+			allocate(expression.derived().width(), expression.derived().height());
+			*this = expression;
+		}
+
 		virtual ~Matrix(void);
 
+		Matrix& operator=(const Matrix& B);
+		Matrix& operator=(Matrix&& B);
+
 		/**
 		 * Prints the matrix to standard out. Intended for testing and debugging.
 		 */
@@ -50,16 +77,82 @@ namespace LibMath
 		 */		
 		size_t height(void) const { return m_h; }
 
+		/**
+		 * Returns the number of doubles between the starts of consecutive rows. Always a multiple of 8, so that every
+		 * row starts on a 64 byte boundary.
+		 */
+		size_t stride(void) const { return m_stride; }
+
 		/**
 		 * Sets the value of the specified element.
 		 */		
-		void set(size_t i, size_t j, double value) { m_data[i][j] = value; }
+		void set(size_t i, size_t j, double value) { m_data[i * m_stride + j] = value; }
+
+		/**
+		 * Returns the value of the specified element.
+		 */
+		double get(size_t i, size_t j) const { return m_data[i * m_stride + j]; }
+
+		/**
+		 * Returns a pointer to the start of row i. Elements of a row are contiguous.
+		 */
+		double* row(size_t i) { return m_data + i * m_stride; }
+		const double* row(size_t i) const { return m_data + i * m_stride; }
+
+		/**
+		 * Returns a view of the whole matrix, for blocks, rows, columns and transposes without copies (see MatrixView.h).
+		 */
+		BasicMatrixView<double> view(void);
+		BasicMatrixView<const double> view(void) const;
+
+		/**
+		 * Evaluates an elementwise expression (see Expression.h) into this matrix in one pass. The expression must have
+		 * the same dimensions; otherwise the matrix is left alone.
+		 */
+		template <typename E>
+		Matrix& operator=(const Expression<E>& expression)
+		{
+			static_assert(E::rank == 2, "Only matrix expressions can be assigned to a matrix.");
+			const E& e = expression.derived();
+
+			// Sanity check.
+			if (!e.conforms(m_w, m_h))
+				return *this;
+
+			// Groups of four vectorize at -O2 as well as -O3. Each element depends only on the same element of each
+			// operand, so there are no dependences between iterations even when this matrix is one of the operands.
+			for (size_t i = 0; i < m_w; ++i)
+			{
+				double* rowI = row(i);
+				size_t j = 0;
+				for (; j + 4 <= m_h; j += 4)
+				{
+					double v0 = e(i, j);
+					double v1 = e(i, j + 1);
+					double v2 = e(i, j + 2);
+					double v3 = e(i, j + 3);
+					rowI[j] = v0;
+					rowI[j + 1] = v1;
+					rowI[j + 2] = v2;
+					rowI[j + 3] = v3;
+				}
+				for (; j < m_h; ++j)
+					rowI[j] = e(i, j);
+			}
+			return *this;
+		}
 
 		/**
 		 * Returns C = A x B, where A is a matrix and B and C are vectors.
 		 */
 		void multiply(const Matrix* B, Vector* C);
 
+		/**
+		 * Returns C = A x B, where A, B, and C are matrices. B must have as many rows as A has columns, and C must have
+		 * A's rows and B's columns. C must not be A or B.
+		 */
+		void multiply(const Matrix* B, Matrix* C) const;
+
 		/**
 		 * Multiplies the matrix by the supplied scalar.
 		 */
@@ -81,13 +174,25 @@ namespace LibMath
 		void zero(void);
 
 	protected:
-		size_t   m_w;
-		size_t   m_h;
-		double** m_data;
+		size_t  m_w;
+		size_t  m_h;
+		size_t  m_stride; // doubles per row, including padding
+		double* m_data;   // m_w rows of m_stride doubles, in one 64 byte aligned block
 		
 	protected:
-		Matrix();
+		void allocate(size_t w, size_t h);
+		void release(void);
 	};
+
+	/**
+	 * Returns A x B by value. Returns an empty matrix if the dimensions don't agree.
+	 */
+	Matrix operator*(const Matrix& A, const Matrix& B);
+
+	/**
+	 * Returns A x v by value. Returns an empty vector if the dimensions don't agree.
+	 */
+	Vector operator*(const Matrix& A, const Vector& v);
 }
 
 #endif
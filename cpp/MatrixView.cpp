@@ -0,0 +1,184 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MatrixView.h"
+#include "Gemm.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace LibMath
+{
+	namespace
+	{
+	/// Square tiles for walking views whose storage orders differ, so both sides stay in cache.
+	const size_t TILE = 32;
+
+	/// Distance between vertically adjacent elements, and between horizontally adjacent elements, of a view.
+	size_t rowStep(ConstMatrixView v) { return v.isTransposed() ? 1 : v.stride(); }
+	size_t columnStep(ConstMatrixView v) { return v.isTransposed() ? v.stride() : 1; }
+
+	/// True if the elements of a single column view are contiguous, so it can be handed to GEMV as a vector.
+	bool isContiguousColumn(ConstMatrixView v) { return (v.height() == 1) && ((rowStep(v) == 1) || (v.width() <= 1)); }
+
+	/// Runs fn(i, j0, j1) over row segments of a w x h view: whole rows, or TILE x TILE tiles when 'tiled'.
+	template <typename Fn>
+	void forSegments(size_t w, size_t h, bool tiled, Fn fn)
+	{
+		if (!tiled)
+		{
+			for (size_t i = 0; i < w; ++i)
+				fn(i, 0, h);
+			return;
+		}
+		for (size_t i0 = 0; i0 < w; i0 += TILE)
+			for (size_t j0 = 0; j0 < h; j0 += TILE)
+				for (size_t i = i0; i < std::min(i0 + TILE, w); ++i)
+					fn(i, j0, std::min(j0 + TILE, h));
+	}
+	}
+
+	void multiply(ConstMatrixView A, ConstMatrixView B, MatrixView C, double alpha, double beta)
+	{
+		// Sanity check.
+		if ((A.height() != B.width()) || (C.width() != A.width()) || (C.height() != B.height()))
+			return;
+
+		// GEMV takes A as stored, with a transpose flag.
+		if (isContiguousColumn(B) && isContiguousColumn(C))
+		{
+			size_t storedRows = A.isTransposed() ? A.height() : A.width();
+			size_t storedCols = A.isTransposed() ? A.width() : A.height();
+			Gemm::multiplyVector(A.isTransposed(), storedRows, storedCols, alpha, A.data(), A.stride(), B.data(), beta, C.data());
+			return;
+		}
+
+		if (!C.isTransposed())
+		{
+			Gemm::multiply(A.isTransposed(), B.isTransposed(), C.width(), C.height(), A.height(), alpha,
+				A.data(), A.stride(), B.data(), B.stride(), beta, C.data(), C.stride());
+			return;
+		}
+
+		// C^T = B^T x A^T, which writes C in its storage order.
+		Gemm::multiply(!B.isTransposed(), !A.isTransposed(), C.height(), C.width(), A.height(), alpha,
+			B.data(), B.stride(), A.data(), A.stride(), beta, C.data(), C.stride());
+	}
+
+	void subtract(ConstMatrixView A, ConstMatrixView B, MatrixView C)
+	{
+		// Sanity check.
+		if ((A.width() != C.width()) || (A.height() != C.height()) || (B.width() != C.width()) || (B.height() != C.height()))
+			return;
+
+		// Walk C in its storage order: C^T = A^T - B^T.
+		if (C.isTransposed())
+		{
+			A = A.transpose();
+			B = B.transpose();
+			C = C.transpose();
+		}
+
+		const double* a = A.data();
+		const double* b = B.data();
+		double* c = C.data();
+		size_t ai = rowStep(A), aj = columnStep(A);
+		size_t bi = rowStep(B), bj = columnStep(B);
+		size_t ci = C.stride();
+		if ((aj == 1) && (bj == 1))
+		{
+			forSegments(C.width(), C.height(), false, [&](size_t i, size_t j0, size_t j1) {
+				const double* rowA = a + i * ai;
+				const double* rowB = b + i * bi;
+				double* rowC = c + i * ci;
+				for (size_t j = j0; j < j1; ++j)
+					rowC[j] = rowA[j] - rowB[j];
+			});
+			return;
+		}
+		forSegments(C.width(), C.height(), true, [&](size_t i, size_t j0, size_t j1) {
+			for (size_t j = j0; j < j1; ++j)
+				c[i * ci + j] = a[i * ai + j * aj] - b[i * bi + j * bj];
+		});
+	}
+
+	double dot(ConstMatrixView A, ConstMatrixView B)
+	{
+		// Sanity check.
+		if ((A.width() != B.width()) || (A.height() != B.height()))
+			return (double)0.0;
+
+		if (A.isTransposed())
+		{
+			A = A.transpose();
+			B = B.transpose();
+		}
+
+		const double* a = A.data();
+		const double* b = B.data();
+		size_t ai = A.stride();
+		size_t bi = rowStep(B), bj = columnStep(B);
+		double result = (double)0.0;
+		if (bj == 1)
+		{
+			forSegments(A.width(), A.height(), false, [&](size_t i, size_t j0, size_t j1) {
+				const double* rowA = a + i * ai;
+				const double* rowB = b + i * bi;
+				for (size_t j = j0; j < j1; ++j)
+					result += rowA[j] * rowB[j];
+			});
+			return result;
+		}
+		forSegments(A.width(), A.height(), true, [&](size_t i, size_t j0, size_t j1) {
+			for (size_t j = j0; j < j1; ++j)
+				result += a[i * ai + j] * b[i * bi + j * bj];
+		});
+		return result;
+	}
+
+	void copy(ConstMatrixView A, MatrixView C)
+	{
+		// Sanity check.
+		if ((A.width() != C.width()) || (A.height() != C.height()))
+			return;
+
+		if (C.isTransposed())
+		{
+			A = A.transpose();
+			C = C.transpose();
+		}
+
+		const double* a = A.data();
+		double* c = C.data();
+		size_t ai = rowStep(A), aj = columnStep(A);
+		size_t ci = C.stride();
+		if (aj == 1)
+		{
+			for (size_t i = 0; i < C.width(); ++i)
+				memcpy(c + i * ci, a + i * ai, C.height() * sizeof(double));
+			return;
+		}
+		forSegments(C.width(), C.height(), true, [&](size_t i, size_t j0, size_t j1) {
+			for (size_t j = j0; j < j1; ++j)
+				c[i * ci + j] = a[i * ai + j * aj];
+		});
+	}
+}
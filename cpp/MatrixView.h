@@ -0,0 +1,146 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _MATRIXVIEW_
+#define _MATRIXVIEW_
+
+#include <stdlib.h>
+#include <type_traits>
+#include "Matrix.h"
+#include "Vector.h"
+
+namespace LibMath
+{
+	/**
+	 * A non-owning window onto row-major storage: a Matrix or SquareMatrix, a Vector (as one column), or an external
+	 * buffer. width and height have the same meaning as for Matrix. Element (i, j) is data[i * stride + j], or, for a
+	 * transposed view, data[j * stride + i].
+	 *
+	 * Views are a pointer and four numbers, so blocks, rows, columns and transposes are made in O(1) without copying.
+	 * A view doesn't keep its storage alive, and is invalidated by anything that reallocates it.
+	 *
+	 * MatrixView can write through to the storage; ConstMatrixView can't. A MatrixView converts to a ConstMatrixView.
+	 */
+	template <typename T>
+	class BasicMatrixView
+	{
+		typedef typename std::conditional<std::is_const<T>::value, const Matrix, Matrix>::type MatrixType;
+		typedef typename std::conditional<std::is_const<T>::value, const Vector, Vector>::type VectorType;
+
+	public:
+		/**
+		 * An empty, 0 x 0 view.
+		 */
+		BasicMatrixView(void) : m_data(NULL), m_w(0), m_h(0), m_stride(0), m_transposed(false) {}
+
+		/**
+		 * A w x h view of a buffer with 'stride' elements between the starts of consecutive rows as stored.
+		 */
+		BasicMatrixView(T* data, size_t w, size_t h, size_t stride, bool transposed = false)
+			: m_data(data), m_w(w), m_h(h), m_stride(stride), m_transposed(transposed) {}
+
+		/**
+		 * Views all of a matrix, or a vector as a single column.
+		 */
+		BasicMatrixView(MatrixType* m) : m_data(m->row(0)), m_w(m->width()), m_h(m->height()), m_stride(m->stride()), m_transposed(false) {}
+		BasicMatrixView(VectorType* v) : m_data(v->m_data), m_w(v->size()), m_h(1), m_stride(1), m_transposed(false) {}
+
+		/**
+		 * Adds const.
+		 */
+		template <typename U, typename = typename std::enable_if<std::is_same<const U, T>::value && !std::is_same<U, T>::value>::type>
+		BasicMatrixView(const BasicMatrixView<U>& v) : m_data(v.data()), m_w(v.width()), m_h(v.height()), m_stride(v.stride()), m_transposed(v.isTransposed()) {}
+
+		size_t width(void) const { return m_w; }
+		size_t height(void) const { return m_h; }
+
+		/**
+		 * The storage as the view was made: the first element, the distance between rows as stored, and whether rows
+		 * as stored are the view's columns.
+		 */
+		T* data(void) const { return m_data; }
+		size_t stride(void) const { return m_stride; }
+		bool isTransposed(void) const { return m_transposed; }
+
+		double get(size_t i, size_t j) const { return m_data[offset(i, j)]; }
+		void set(size_t i, size_t j, double value) const { m_data[offset(i, j)] = value; }
+		T& operator()(size_t i, size_t j) const { return m_data[offset(i, j)]; }
+
+		/**
+		 * Returns the w x h block whose top left element is (i, j). The block must lie inside the view.
+		 */
+		BasicMatrixView block(size_t i, size_t j, size_t w, size_t h) const
+		{
+			return BasicMatrixView(m_data + offset(i, j), w, h, m_stride, m_transposed);
+		}
+
+		/**
+		 * Returns row i as a 1 x height view, or column j as a width x 1 view.
+		 */
+		BasicMatrixView row(size_t i) const { return block(i, 0, 1, m_h); }
+		BasicMatrixView column(size_t j) const { return block(0, j, m_w, 1); }
+
+		/**
+		 * Returns the transpose, over the same storage.
+		 */
+		BasicMatrixView transpose(void) const { return BasicMatrixView(m_data, m_h, m_w, m_stride, !m_transposed); }
+
+	private:
+		T*     m_data;
+		size_t m_w;
+		size_t m_h;
+		size_t m_stride;
+		bool   m_transposed;
+
+		size_t offset(size_t i, size_t j) const { return m_transposed ? j * m_stride + i : i * m_stride + j; }
+	};
+
+	typedef BasicMatrixView<double> MatrixView;
+	typedef BasicMatrixView<const double> ConstMatrixView;
+
+	/**
+	 * C = alpha * A x B + beta * C, through the blocked GEMM whatever the views' transposes. A must be m x k, B k x n
+	 * and C m x n; otherwise C is left alone. C must not overlap A or B.
+	 */
+	void multiply(ConstMatrixView A, ConstMatrixView B, MatrixView C, double alpha = 1.0, double beta = 0.0);
+
+	/**
+	 * C = A - B, elementwise. All three must have the same dimensions. C may be A or B, for updates in place, but
+	 * must not otherwise overlap them.
+	 */
+	void subtract(ConstMatrixView A, ConstMatrixView B, MatrixView C);
+
+	/**
+	 * Returns the sum of the products of corresponding elements (the Frobenius inner product; the ordinary dot
+	 * product for rows or columns). Returns zero if the dimensions differ.
+	 */
+	double dot(ConstMatrixView A, ConstMatrixView B);
+
+	/**
+	 * Copies A into C, which must have the same dimensions and must not overlap it. Copying a transposed view
+	 * materializes the transpose.
+	 */
+	void copy(ConstMatrixView A, MatrixView C);
+}
+
+#endif
@@ -0,0 +1,210 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Parallel.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LibMath
+{
+	static std::atomic<size_t> g_numThreads(0);
+
+	namespace
+	{
+	/// Set on pool workers, and on a thread while it drives the pool, so that nested loops don't wait on the pool.
+	thread_local bool t_inPool = false;
+
+	/// Returns the start of chunk 'chunk' when [0, count) is cut into numChunks nearly equal pieces.
+	size_t chunkBegin(size_t count, size_t numChunks, size_t chunk)
+	{
+		size_t chunkSize = count / numChunks;
+		size_t remainder = count % numChunks;
+		return chunk * chunkSize + ((chunk < remainder) ? chunk : remainder);
+	}
+
+	/**
+	 * Worker threads that sleep between loops. A loop publishes a job under the mutex and bumps the generation; workers
+	 * that wake take chunks from an atomic counter alongside the calling thread. The caller returns only once no
+	 * worker is inside the job, and a new job isn't published until then either, so a late worker can never mix one
+	 * job's function with another's chunks.
+	 */
+	class ThreadPool
+	{
+	public:
+		static ThreadPool& instance(void)
+		{
+			static ThreadPool pool;
+			return pool;
+		}
+
+		~ThreadPool(void)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+			m_wake.notify_all();
+			for (auto iter = m_workers.begin(); iter != m_workers.end(); ++iter)
+				iter->join();
+		}
+
+		/// Runs the job, or returns false without running anything if the pool is already in use.
+		bool tryRun(size_t count, size_t numChunks, void (*fn)(void*, size_t, size_t), void* context)
+		{
+			if (t_inPool)
+				return false;
+			std::unique_lock<std::mutex> owner(m_owner, std::try_to_lock);
+			if (!owner.owns_lock())
+				return false;
+			t_inPool = true;
+
+			// Only grows, so steady state loops don't allocate.
+			while (m_workers.size() + 1 < numChunks)
+				m_workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_idle.wait(lock, [this] { return m_active == 0; });
+				m_fn = fn;
+				m_context = context;
+				m_count = count;
+				m_numChunks = numChunks;
+				m_nextChunk.store(0);
+				++m_generation;
+			}
+			m_wake.notify_all();
+
+			work(fn, context, count, numChunks);
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_idle.wait(lock, [this] { return m_active == 0; });
+			}
+			t_inPool = false;
+			return true;
+		}
+
+	private:
+		std::mutex               m_owner;      // held by the thread driving the current loop
+		std::mutex               m_mutex;      // guards the job and the counts below
+		std::condition_variable  m_wake;
+		std::condition_variable  m_idle;
+		std::vector<std::thread> m_workers;
+		void                   (*m_fn)(void*, size_t, size_t) = NULL;
+		void*                    m_context = NULL;
+		size_t                   m_count = 0;
+		size_t                   m_numChunks = 0;
+		std::atomic<size_t>      m_nextChunk{0};
+		size_t                   m_generation = 0;
+		size_t                   m_active = 0;  // workers inside the current job
+		bool                     m_stop = false;
+
+		void work(void (*fn)(void*, size_t, size_t), void* context, size_t count, size_t numChunks)
+		{
+			size_t chunk;
+			while ((chunk = m_nextChunk.fetch_add(1)) < numChunks)
+				fn(context, chunkBegin(count, numChunks, chunk), chunkBegin(count, numChunks, chunk + 1));
+		}
+
+		void workerLoop(void)
+		{
+			t_inPool = true;
+			std::unique_lock<std::mutex> lock(m_mutex);
+			size_t seen = m_generation;
+			while (true)
+			{
+				m_wake.wait(lock, [&] { return m_stop || (m_generation != seen); });
+				if (m_stop)
+					return;
+				seen = m_generation;
+				void (*fn)(void*, size_t, size_t) = m_fn;
+				void* context = m_context;
+				size_t count = m_count;
+				size_t numChunks = m_numChunks;
+				++m_active;
+				lock.unlock();
+
+				work(fn, context, count, numChunks);
+
+				lock.lock();
+				if (--m_active == 0)
+					m_idle.notify_all();
+			}
+		}
+	};
+	}
+
+	size_t Parallel::numThreads(void)
+	{
+		size_t numThreads = g_numThreads.load();
+		if (numThreads == 0)
+		{
+			numThreads = std::thread::hardware_concurrency();
+		}
+		return (numThreads == 0) ? 1 : numThreads;
+	}
+
+	void Parallel::setNumThreads(size_t numThreads)
+	{
+		g_numThreads.store(numThreads);
+	}
+
+	size_t Parallel::chunks(size_t count, size_t minChunk)
+	{
+		if (count == 0)
+		{
+			return 0;
+		}
+		if (minChunk == 0)
+		{
+			minChunk = 1;
+		}
+
+		size_t numChunks = (count + minChunk - 1) / minChunk;
+		size_t maxThreads = numThreads();
+		return (numChunks > maxThreads) ? maxThreads : numChunks;
+	}
+
+	void Parallel::run(size_t count, size_t numChunks, RangeFunction fn, void* context)
+	{
+		if (ThreadPool::instance().tryRun(count, numChunks, fn, context))
+		{
+			return;
+		}
+
+		// The pool is busy: hand out the chunks to threads of our own, keeping the last one for the calling thread.
+		std::vector<std::thread> threads;
+		threads.reserve(numChunks - 1);
+		for (size_t chunk = 0; chunk + 1 < numChunks; ++chunk)
+		{
+			threads.push_back(std::thread(fn, context, chunkBegin(count, numChunks, chunk), chunkBegin(count, numChunks, chunk + 1)));
+		}
+		fn(context, chunkBegin(count, numChunks, numChunks - 1), count);
+		for (auto iter = threads.begin(); iter != threads.end(); ++iter)
+		{
+			iter->join();
+		}
+	}
+}
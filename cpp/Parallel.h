@@ -0,0 +1,86 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _PARALLEL_
+#define _PARALLEL_
+
+#include <stdlib.h>
+#include <type_traits>
+
+namespace LibMath
+{
+	/**
+	 * Minimal helpers for spreading a loop across threads.
+	 */
+	class Parallel
+	{
+	public:
+		/**
+		 * Returns the number of threads that parallel loops will use. Defaults to the number of hardware threads.
+		 */
+		static size_t numThreads(void);
+
+		/**
+		 * Sets the number of threads that parallel loops will use. Zero restores the default.
+		 */
+		static void setNumThreads(size_t numThreads);
+
+		/**
+		 * Splits [0, count) into contiguous ranges of at least 'minChunk' items and calls 'fn(begin, end)' for each,
+		 * one range per thread. Runs on the calling thread alone when the work is too small to be worth splitting.
+		 *
+		 * Ranges run on a pool of persistent worker threads plus the calling thread, and neither path allocates once
+		 * the pool has grown to size. A loop started while the pool is busy (from inside another loop, or from another
+		 * thread) runs on threads of its own instead.
+		 */
+		template <typename Fn>
+		static void forRange(size_t count, size_t minChunk, Fn&& fn)
+		{
+			typedef typename std::remove_reference<Fn>::type Function;
+
+			size_t numChunks = chunks(count, minChunk);
+			if (numChunks == 0)
+				return;
+			if (numChunks == 1)
+			{
+				fn((size_t)0, count);
+				return;
+			}
+			run(count, numChunks, &invoke<Function>, (void*)&fn);
+		}
+
+	private:
+		typedef void (*RangeFunction)(void* context, size_t begin, size_t end);
+
+		template <typename Function>
+		static void invoke(void* context, size_t begin, size_t end)
+		{
+			(*(Function*)context)(begin, end);
+		}
+
+		static size_t chunks(size_t count, size_t minChunk);
+		static void run(size_t count, size_t numChunks, RangeFunction fn, void* context);
+	};
+}
+
+#endif
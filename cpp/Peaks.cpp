@@ -22,6 +22,7 @@
 #include "Peaks.h"
 #include "Statistics.h"
 
+#include <algorithm>
 #include <string.h>
 #include <math.h>
 
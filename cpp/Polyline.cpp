@@ -0,0 +1,318 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Polyline.h"
+#include "Distance.h"
+
+#include <algorithm>
+#include <functional>
+#include <math.h>
+#include <queue>
+#include <string.h>
+
+namespace LibMath
+{
+	namespace
+	{
+	inline double dot(const double* a, const double* b)
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	inline void cross(const double* a, const double* b, double* out)
+	{
+		out[0] = a[1] * b[2] - a[2] * b[1];
+		out[1] = a[2] * b[0] - a[0] * b[2];
+		out[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	/// Angle between two unit vectors, from their chord.
+	inline double angleBetween(const double* a, const double* b)
+	{
+		double dx = a[0] - b[0];
+		double dy = a[1] - b[1];
+		double dz = a[2] - b[2];
+		return (double)2.0 * asin(std::min((double)0.5 * sqrt(dx * dx + dy * dy + dz * dz), (double)1.0));
+	}
+
+	/// Great circle segment from a to b, set up for repeated distance queries.
+	struct Segment
+	{
+		const double* a;
+		const double* b;
+		double        normal[3]; // unit normal of the great circle through a and b
+		bool          degenerate;
+
+		Segment(const double* start, const double* end) : a(start), b(end)
+		{
+			cross(a, b, normal);
+			double len = sqrt(dot(normal, normal));
+			degenerate = (len < (double)1e-15);
+			if (!degenerate)
+			{
+				normal[0] /= len;
+				normal[1] /= len;
+				normal[2] /= len;
+			}
+		}
+
+		/// Angle from p to the nearest point of the segment.
+		double angleTo(const double* p) const
+		{
+			if (degenerate)
+				return angleBetween(a, p);
+
+			// The foot of the perpendicular is on the segment when p is on the inner side of both of the great circles
+			// through a and b perpendicular to it; then the distance is the cross track distance.
+			double ap[3], pb[3];
+			cross(a, p, ap);
+			cross(p, b, pb);
+			if ((dot(ap, normal) >= (double)0.0) && (dot(pb, normal) >= (double)0.0))
+				return asin(std::min(fabs(dot(p, normal)), (double)1.0));
+			return std::min(angleBetween(a, p), angleBetween(b, p));
+		}
+	};
+
+	/// Area of the spherical triangle a, b, c on the unit sphere (its spherical excess).
+	inline double triangleArea(const double* a, const double* b, const double* c)
+	{
+		double bc[3];
+		cross(b, c, bc);
+		return (double)2.0 * atan2(fabs(dot(a, bc)), (double)1.0 + dot(a, b) + dot(b, c) + dot(c, a));
+	}
+
+	std::vector<double> toUnitVectors(const double* lat, const double* lon, size_t numPoints)
+	{
+		std::vector<double> xyz(numPoints * 3);
+		for (size_t i = 0; i < numPoints; ++i)
+			Distance::toUnitVector(lat[i], lon[i], xyz.data() + i * 3);
+		return xyz;
+	}
+	}
+
+	size_t Polyline::douglasPeucker(const double* lat, const double* lon, size_t numPoints, double toleranceMeters, size_t* keptIndices)
+	{
+		// Sanity check.
+		if (numPoints <= 2)
+		{
+			for (size_t i = 0; i < numPoints; ++i)
+				keptIndices[i] = i;
+			return numPoints;
+		}
+
+		std::vector<double> xyz = toUnitVectors(lat, lon, numPoints);
+		std::vector<char> keep(numPoints, 0);
+		keep[0] = 1;
+		keep[numPoints - 1] = 1;
+		double toleranceAngle = toleranceMeters / Distance::EARTH_RADIUS;
+
+		std::vector<std::pair<size_t, size_t> > stack;
+		stack.push_back(std::make_pair((size_t)0, numPoints - 1));
+		while (!stack.empty())
+		{
+			size_t first = stack.back().first;
+			size_t last = stack.back().second;
+			stack.pop_back();
+
+			Segment segment(xyz.data() + first * 3, xyz.data() + last * 3);
+			double farthest = (double)-1.0;
+			size_t farthestIndex = first;
+			for (size_t i = first + 1; i < last; ++i)
+			{
+				double angle = segment.angleTo(xyz.data() + i * 3);
+				if (angle > farthest)
+				{
+					farthest = angle;
+					farthestIndex = i;
+				}
+			}
+
+			if (farthest > toleranceAngle)
+			{
+				keep[farthestIndex] = 1;
+				if (farthestIndex - first > 1)
+					stack.push_back(std::make_pair(first, farthestIndex));
+				if (last - farthestIndex > 1)
+					stack.push_back(std::make_pair(farthestIndex, last));
+			}
+		}
+
+		size_t numKept = 0;
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			if (keep[i])
+				keptIndices[numKept++] = i;
+		}
+		return numKept;
+	}
+
+	size_t Polyline::visvalingamWhyatt(const double* lat, const double* lon, size_t numPoints, double minAreaSquareMeters, size_t* keptIndices)
+	{
+		// Sanity check.
+		if (numPoints <= 2)
+		{
+			for (size_t i = 0; i < numPoints; ++i)
+				keptIndices[i] = i;
+			return numPoints;
+		}
+
+		std::vector<double> xyz = toUnitVectors(lat, lon, numPoints);
+		double minArea = minAreaSquareMeters / (Distance::EARTH_RADIUS * Distance::EARTH_RADIUS);
+
+		// The remaining points form a doubly linked list. The heap can hold stale entries for points whose area has
+		// changed or that are gone; those are recognized by comparing against 'areas' and skipped.
+		std::vector<size_t> prev(numPoints), next(numPoints);
+		std::vector<double> areas(numPoints, HUGE_VAL);
+		typedef std::pair<double, size_t> Entry;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > heap;
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			prev[i] = i - 1;
+			next[i] = i + 1;
+			if ((i > 0) && (i + 1 < numPoints))
+			{
+				areas[i] = triangleArea(xyz.data() + (i - 1) * 3, xyz.data() + i * 3, xyz.data() + (i + 1) * 3);
+				heap.push(std::make_pair(areas[i], i));
+			}
+		}
+
+		std::vector<char> removed(numPoints, 0);
+		while (!heap.empty())
+		{
+			Entry entry = heap.top();
+			heap.pop();
+			size_t i = entry.second;
+			if (removed[i] || (entry.first != areas[i]))
+				continue;
+			if (entry.first >= minArea)
+				break;
+
+			removed[i] = 1;
+			size_t before = prev[i];
+			size_t after = next[i];
+			next[before] = after;
+			prev[after] = before;
+
+			// A neighbor's new triangle can't count as smaller than the one just removed; otherwise
+			// points would be dropped out of order of their visual significance.
+			size_t neighbors[2] = { before, after };
+			for (size_t n = 0; n < 2; ++n)
+			{
+				size_t j = neighbors[n];
+				if ((j == 0) || (j + 1 == numPoints))
+					continue;
+				double area = triangleArea(xyz.data() + prev[j] * 3, xyz.data() + j * 3, xyz.data() + next[j] * 3);
+				areas[j] = std::max(area, entry.first);
+				heap.push(std::make_pair(areas[j], j));
+			}
+		}
+
+		size_t numKept = 0;
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			if (!removed[i])
+				keptIndices[numKept++] = i;
+		}
+		return numKept;
+	}
+
+	LivePolyline::LivePolyline(double toleranceMeters, size_t maxPending)
+	{
+		m_toleranceAngle = toleranceMeters / Distance::EARTH_RADIUS;
+		m_maxPending = (maxPending < 2) ? 2 : maxPending;
+		m_pending = new double[m_maxPending * 3];
+		reset();
+	}
+
+	LivePolyline::~LivePolyline(void)
+	{
+		delete[] m_pending;
+	}
+
+	void LivePolyline::reset(void)
+	{
+		m_numPoints = 0;
+		m_numPending = 0;
+		m_lastLat = (double)0.0;
+		m_lastLon = (double)0.0;
+		m_keptIndices.clear();
+		m_keptLat.clear();
+		m_keptLon.clear();
+	}
+
+	void LivePolyline::keep(size_t index, double lat, double lon, const double* xyz)
+	{
+		m_keptIndices.push_back(index);
+		m_keptLat.push_back(lat);
+		m_keptLon.push_back(lon);
+		memcpy(m_anchor, xyz, sizeof(m_anchor));
+	}
+
+	bool LivePolyline::addPoint(double lat, double lon)
+	{
+		double xyz[3];
+		Distance::toUnitVector(lat, lon, xyz);
+		size_t index = m_numPoints++;
+
+		if (index == 0)
+		{
+			keep(index, lat, lon, xyz);
+			m_lastLat = lat;
+			m_lastLon = lon;
+			return false;
+		}
+
+		// Can the line from the last kept point to this one skip every point in between?
+		bool fits = (m_numPending < m_maxPending);
+		if (fits)
+		{
+			Segment segment(m_anchor, xyz);
+			for (size_t i = 0; fits && (i < m_numPending); ++i)
+				fits = (segment.angleTo(m_pending + i * 3) <= m_toleranceAngle);
+		}
+
+		bool kept = false;
+		if (!fits)
+		{
+			// Keep the previous point instead, and start again from it.
+			const double* previous = m_pending + (m_numPending - 1) * 3;
+			keep(index - 1, m_lastLat, m_lastLon, previous);
+			m_numPending = 0;
+			kept = true;
+		}
+
+		memcpy(m_pending + m_numPending * 3, xyz, sizeof(xyz));
+		++m_numPending;
+		m_lastLat = lat;
+		m_lastLon = lon;
+		return kept;
+	}
+
+	bool LivePolyline::finish(void)
+	{
+		if (m_numPending == 0)
+			return false;
+
+		keep(m_numPoints - 1, m_lastLat, m_lastLon, m_pending + (m_numPending - 1) * 3);
+		m_numPending = 0;
+		return true;
+	}
+}
@@ -0,0 +1,112 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _POLYLINE_
+#define _POLYLINE_
+
+#include <stdlib.h>
+#include <vector>
+
+namespace LibMath
+{
+	/**
+	 * Simplification of polylines (GPS tracks, region outlines) given as latitude/longitude in degrees. Distances and
+	 * areas are measured on the same sphere as Distance::haversineDistance. The first and last points are always kept.
+	 */
+	class Polyline
+	{
+	public:
+		/**
+		 * Douglas-Peucker: keeps the fewest points such that every dropped point is within 'toleranceMeters' of the
+		 * simplified line. Writes the indices of the kept points, in order, to 'keptIndices' (which must have room for
+		 * 'numPoints') and returns how many there are. Uses an explicit stack, so long tracks can't overflow the call stack;
+		 * typically O(n log n), O(n^2) in the worst case.
+		 */
+		static size_t douglasPeucker(const double* lat, const double* lon, size_t numPoints, double toleranceMeters, size_t* keptIndices);
+
+		/**
+		 * Visvalingam-Whyatt: repeatedly drops the point whose triangle with its neighbors has the smallest area, until
+		 * every remaining triangle covers at least 'minAreaSquareMeters'. Output as for douglasPeucker. O(n log n).
+		 */
+		static size_t visvalingamWhyatt(const double* lat, const double* lon, size_t numPoints, double minAreaSquareMeters, size_t* keptIndices);
+	};
+
+	/**
+	 * Streaming simplification, for live tracks: points are added one at a time and a point is kept as soon as the line
+	 * from the last kept point can no longer skip it within 'toleranceMeters'. Work and memory per point are bounded by
+	 * 'maxPending', the most points that will be skipped in a row.
+	 */
+	class LivePolyline
+	{
+	public:
+		LivePolyline(double toleranceMeters, size_t maxPending = 64);
+		virtual ~LivePolyline(void);
+
+		/**
+		 * Adds the next point. Returns TRUE if this caused an earlier point to be kept.
+		 */
+		bool addPoint(double lat, double lon);
+
+		/**
+		 * Keeps the last point added, ending the line. Returns TRUE if it wasn't already kept.
+		 */
+		bool finish(void);
+
+		/**
+		 * Forgets all of the points added so far.
+		 */
+		void reset(void);
+
+		/**
+		 * Returns the number of points added so far.
+		 */
+		size_t numPoints(void) const { return m_numPoints; }
+
+		/**
+		 * The kept points: their positions in the sequence passed to addPoint, and their coordinates.
+		 */
+		const std::vector<size_t>& keptIndices(void) const { return m_keptIndices; }
+		const std::vector<double>& keptLatitudes(void) const { return m_keptLat; }
+		const std::vector<double>& keptLongitudes(void) const { return m_keptLon; }
+
+	private:
+		double              m_toleranceAngle; // tolerance, as an angle at the center of the earth
+		size_t              m_maxPending;
+		size_t              m_numPoints;
+		size_t              m_numPending;     // points added since the last kept one
+		double              m_anchor[3];      // unit vector of the last kept point
+		double*             m_pending;        // unit vectors of the points since then
+		double              m_lastLat;
+		double              m_lastLon;
+		std::vector<size_t> m_keptIndices;
+		std::vector<double> m_keptLat;
+		std::vector<double> m_keptLon;
+
+		void keep(size_t index, double lat, double lon, const double* xyz);
+
+		LivePolyline(const LivePolyline&);
+		LivePolyline& operator=(const LivePolyline&);
+	};
+}
+
+#endif
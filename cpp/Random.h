@@ -0,0 +1,95 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _RANDOM_
+#define _RANDOM_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace LibMath
+{
+	/**
+	 * Small, fast, seedable pseudo random number generator (xoshiro256**, seeded with splitmix64).
+	 * Not suitable for cryptographic use. Use this instead of rand() when results need to be repeatable,
+	 * or when several generators need to run independently (one per thread, for example).
+	 */
+	class Random
+	{
+	public:
+		Random(uint64_t seed = 0) { setSeed(seed); }
+
+		/**
+		 * Resets the generator state from the given seed.
+		 */
+		void setSeed(uint64_t seed)
+		{
+			for (size_t i = 0; i < 4; ++i)
+			{
+				seed += 0x9e3779b97f4a7c15ULL;
+				uint64_t z = seed;
+				z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+				z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+				m_state[i] = z ^ (z >> 31);
+			}
+		}
+
+		/**
+		 * Returns the next 64 random bits.
+		 */
+		uint64_t next(void)
+		{
+			uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+			uint64_t t = m_state[1] << 17;
+
+			m_state[2] ^= m_state[0];
+			m_state[3] ^= m_state[1];
+			m_state[1] ^= m_state[2];
+			m_state[0] ^= m_state[3];
+			m_state[2] ^= t;
+			m_state[3] = rotl(m_state[3], 45);
+			return result;
+		}
+
+		/**
+		 * Returns a uniformly distributed double in [0, 1).
+		 */
+		double nextDouble(void) { return (double)(next() >> 11) * (double)(1.0 / 9007199254740992.0); }
+
+		/**
+		 * Returns a uniformly distributed index in [0, n). n must be greater than zero.
+		 */
+		size_t nextIndex(size_t n)
+		{
+			size_t index = (size_t)(nextDouble() * (double)n);
+			return (index < n) ? index : n - 1;
+		}
+
+	private:
+		uint64_t m_state[4];
+
+		static inline uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+	};
+}
+
+#endif
@@ -24,6 +24,7 @@
 #ifndef _SIGNALS_
 #define _SIGNALS_
 
+#include <stdlib.h>
 #include <vector>
 
 namespace LibMath
@@ -0,0 +1,263 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "SmallMatrixBatch.h"
+
+#include <string.h>
+
+namespace LibMath
+{
+	namespace
+	{
+	// The block layout is fixed at LANES items; each block is processed in pieces as wide as the target's vectors. With
+	// a compiler that lacks vector extensions, the same code runs one item at a time.
+#if defined(__GNUC__)
+#if defined(__AVX512F__)
+	const size_t WIDTH = 8;
+#elif defined(__AVX__)
+	const size_t WIDTH = 4;
+#else
+	const size_t WIDTH = 2;
+#endif
+	typedef double Lanes __attribute__((vector_size(WIDTH * sizeof(double))));
+	typedef long long LaneMask __attribute__((vector_size(WIDTH * sizeof(double))));
+
+	/// 1 / det, or zero where det is zero.
+	inline Lanes safeReciprocal(Lanes det)
+	{
+		return (Lanes)((LaneMask)(1.0 / det) & (LaneMask)(det != 0.0));
+	}
+#else
+	const size_t WIDTH = 1;
+	typedef double Lanes;
+
+	inline Lanes safeReciprocal(Lanes det)
+	{
+		return (det != (double)0.0) ? (double)1.0 / det : (double)0.0;
+	}
+#endif
+
+	const size_t LANES = SmallMatrixBatch::LANES;
+
+	/// Lanes are copied rather than dereferenced, since batches need not be aligned to the vector width.
+	inline Lanes load(const double* p)
+	{
+		Lanes v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	inline void store(Lanes v, double* p)
+	{
+		memcpy(p, &v, sizeof(v));
+	}
+
+	/// Loads an n x n block of lanes, one element row of the layout per entry.
+	template <size_t N>
+	inline void loadMatrix(const double* p, Lanes (&m)[N][N])
+	{
+		for (size_t i = 0; i < N; ++i)
+			for (size_t j = 0; j < N; ++j)
+				m[i][j] = load(p + (i * N + j) * LANES);
+	}
+
+	template <size_t N>
+	inline void storeMatrix(const Lanes (&m)[N][N], double* p)
+	{
+		for (size_t i = 0; i < N; ++i)
+			for (size_t j = 0; j < N; ++j)
+				store(m[i][j], p + (i * N + j) * LANES);
+	}
+
+	/// Number of lanes of 'det' at or past 'first' and before 'count' that are zero.
+	inline size_t countSingular(Lanes det, size_t first, size_t count)
+	{
+		double values[WIDTH];
+		memcpy(values, &det, sizeof(values));
+		size_t singular = 0;
+		for (size_t l = 0; (l < WIDTH) && (first + l < count); ++l)
+			if (values[l] == (double)0.0)
+				++singular;
+		return singular;
+	}
+
+	/// Runs fn(block, piece) over every vector-width piece of every block; the first item of a piece is block * LANES + piece.
+	template <typename Fn>
+	inline void forPieces(size_t count, Fn fn)
+	{
+		for (size_t block = 0; block * LANES < count; ++block)
+			for (size_t piece = 0; piece < LANES; piece += WIDTH)
+				fn(block, piece);
+	}
+
+	template <size_t N>
+	void multiplyItems(size_t count, const double* A, const double* B, double* C)
+	{
+		forPieces(count, [&](size_t block, size_t piece) {
+			size_t offset = block * N * N * LANES + piece;
+#pragma GCC unroll 4
+			for (size_t i = 0; i < N; ++i)
+			{
+				Lanes row[N];
+#pragma GCC unroll 4
+				for (size_t k = 0; k < N; ++k)
+					row[k] = load(A + offset + (i * N + k) * LANES);
+#pragma GCC unroll 4
+				for (size_t j = 0; j < N; ++j)
+				{
+					Lanes sum = row[0] * load(B + offset + j * LANES);
+#pragma GCC unroll 4
+					for (size_t k = 1; k < N; ++k)
+						sum += row[k] * load(B + offset + (k * N + j) * LANES);
+					store(sum, C + offset + (i * N + j) * LANES);
+				}
+			}
+		});
+	}
+
+	template <size_t N>
+	void multiplyVectorItems(size_t count, const double* A, const double* x, double* y)
+	{
+		forPieces(count, [&](size_t block, size_t piece) {
+			size_t offset = block * N * N * LANES + piece;
+			size_t vectorOffset = block * N * LANES + piece;
+			Lanes xs[N];
+			for (size_t k = 0; k < N; ++k)
+				xs[k] = load(x + vectorOffset + k * LANES);
+			for (size_t i = 0; i < N; ++i)
+			{
+				Lanes sum = load(A + offset + i * N * LANES) * xs[0];
+				for (size_t k = 1; k < N; ++k)
+					sum += load(A + offset + (i * N + k) * LANES) * xs[k];
+				store(sum, y + vectorOffset + i * LANES);
+			}
+		});
+	}
+
+	template <size_t N>
+	void determinantItems(size_t count, const double* A, double* det)
+	{
+		forPieces(count, [&](size_t block, size_t piece) {
+			Lanes m[N][N];
+			loadMatrix<N>(A + block * N * N * LANES + piece, m);
+			Lanes d = detail::FixedSquare<Lanes, N>::determinant(m);
+
+			// det isn't padded, so the last piece may be partial.
+			double values[WIDTH];
+			memcpy(values, &d, sizeof(values));
+			size_t first = block * LANES + piece;
+			for (size_t l = 0; (l < WIDTH) && (first + l < count); ++l)
+				det[first + l] = values[l];
+		});
+	}
+
+	template <size_t N>
+	size_t inverseItems(size_t count, const double* A, double* result)
+	{
+		size_t singular = 0;
+		forPieces(count, [&](size_t block, size_t piece) {
+			size_t offset = block * N * N * LANES + piece;
+			Lanes m[N][N];
+			Lanes adjugate[N][N];
+			loadMatrix<N>(A + offset, m);
+			Lanes d = detail::FixedSquare<Lanes, N>::determinant(m);
+			detail::FixedSquare<Lanes, N>::adjugate(m, adjugate);
+			Lanes scale = safeReciprocal(d);
+			for (size_t i = 0; i < N; ++i)
+				for (size_t j = 0; j < N; ++j)
+					adjugate[i][j] *= scale;
+			storeMatrix<N>(adjugate, result + offset);
+			singular += countSingular(d, block * LANES + piece, count);
+		});
+		return singular;
+	}
+
+	template <size_t N>
+	size_t solveItems(size_t count, const double* A, const double* b, double* x)
+	{
+		// x = adj(A) b / det(A): branch free, so every lane follows the same path.
+		size_t singular = 0;
+		forPieces(count, [&](size_t block, size_t piece) {
+			size_t vectorOffset = block * N * LANES + piece;
+			Lanes m[N][N];
+			Lanes adjugate[N][N];
+			Lanes rhs[N];
+			loadMatrix<N>(A + block * N * N * LANES + piece, m);
+			for (size_t k = 0; k < N; ++k)
+				rhs[k] = load(b + vectorOffset + k * LANES);
+			Lanes d = detail::FixedSquare<Lanes, N>::determinant(m);
+			detail::FixedSquare<Lanes, N>::adjugate(m, adjugate);
+			Lanes scale = safeReciprocal(d);
+			for (size_t i = 0; i < N; ++i)
+			{
+				Lanes sum = adjugate[i][0] * rhs[0];
+				for (size_t k = 1; k < N; ++k)
+					sum += adjugate[i][k] * rhs[k];
+				store(sum * scale, x + vectorOffset + i * LANES);
+			}
+			singular += countSingular(d, block * LANES + piece, count);
+		});
+		return singular;
+	}
+	}
+
+	void SmallMatrixBatch::multiply(size_t n, size_t count, const double* A, const double* B, double* C)
+	{
+		if (n == 3)
+			multiplyItems<3>(count, A, B, C);
+		else if (n == 4)
+			multiplyItems<4>(count, A, B, C);
+	}
+
+	void SmallMatrixBatch::multiplyVector(size_t n, size_t count, const double* A, const double* x, double* y)
+	{
+		if (n == 3)
+			multiplyVectorItems<3>(count, A, x, y);
+		else if (n == 4)
+			multiplyVectorItems<4>(count, A, x, y);
+	}
+
+	void SmallMatrixBatch::determinant(size_t n, size_t count, const double* A, double* det)
+	{
+		if (n == 3)
+			determinantItems<3>(count, A, det);
+		else if (n == 4)
+			determinantItems<4>(count, A, det);
+	}
+
+	size_t SmallMatrixBatch::inverse(size_t n, size_t count, const double* A, double* inverse)
+	{
+		if (n == 3)
+			return inverseItems<3>(count, A, inverse);
+		if (n == 4)
+			return inverseItems<4>(count, A, inverse);
+		return 0;
+	}
+
+	size_t SmallMatrixBatch::solve(size_t n, size_t count, const double* A, const double* b, double* x)
+	{
+		if (n == 3)
+			return solveItems<3>(count, A, b, x);
+		if (n == 4)
+			return solveItems<4>(count, A, b, x);
+		return 0;
+	}
+}
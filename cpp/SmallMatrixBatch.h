@@ -0,0 +1,125 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _SMALLMATRIXBATCH_
+#define _SMALLMATRIXBATCH_
+
+#include <stdlib.h>
+#include "FixedMatrix.h"
+
+namespace LibMath
+{
+	/**
+	 * Operations over many independent 3x3 or 4x4 problems at once, such as a rotation per sample.
+	 *
+	 * Batches are stored in interleaved structure-of-arrays (AoSoA) form, in blocks of LANES items. Within a block,
+	 * element (i, j) of all LANES matrices is contiguous, so element (i, j) of item b of an n x n batch is at
+	 * (b / LANES) * n * n * LANES + (i * n + j) * LANES + b % LANES. Vector batches work the same way, with n
+	 * elements per block row. Each element row maps onto SIMD registers, so the lanes of one instruction work on
+	 * different items.
+	 *
+	 * Buffers hold whole blocks (see size and vectorSize). The padding lanes of a partial last block are computed like
+	 * the rest, so they should be initialized, but their results mean nothing.
+	 */
+	class SmallMatrixBatch
+	{
+	public:
+		static const size_t LANES = 8;
+
+		/**
+		 * Returns the number of doubles in a batch of 'count' n x n matrices, or of 'count' n element vectors.
+		 */
+		static size_t size(size_t n, size_t count) { return blocks(count) * n * n * LANES; }
+		static size_t vectorSize(size_t n, size_t count) { return blocks(count) * n * LANES; }
+
+		/**
+		 * Returns the position of element (i, j) of matrix 'item', or element i of vector 'item'.
+		 */
+		static size_t index(size_t n, size_t item, size_t i, size_t j) { return (item / LANES) * n * n * LANES + (i * n + j) * LANES + item % LANES; }
+		static size_t vectorIndex(size_t n, size_t item, size_t i) { return (item / LANES) * n * LANES + i * LANES + item % LANES; }
+
+		/**
+		 * Copies one item between a batch and a fixed size matrix or vector.
+		 */
+		template <size_t N>
+		static void store(const FixedMatrix<double, N, N>& m, double* batch, size_t item)
+		{
+			for (size_t i = 0; i < N; ++i)
+				for (size_t j = 0; j < N; ++j)
+					batch[index(N, item, i, j)] = m.m_data[i][j];
+		}
+		template <size_t N>
+		static FixedMatrix<double, N, N> load(const double* batch, size_t item)
+		{
+			FixedMatrix<double, N, N> m;
+			for (size_t i = 0; i < N; ++i)
+				for (size_t j = 0; j < N; ++j)
+					m.m_data[i][j] = batch[index(N, item, i, j)];
+			return m;
+		}
+		template <size_t N>
+		static void store(const FixedVector<double, N>& v, double* batch, size_t item)
+		{
+			for (size_t i = 0; i < N; ++i)
+				batch[vectorIndex(N, item, i)] = v.m_data[i];
+		}
+		template <size_t N>
+		static FixedVector<double, N> loadVector(const double* batch, size_t item)
+		{
+			FixedVector<double, N> v;
+			for (size_t i = 0; i < N; ++i)
+				v.m_data[i] = batch[vectorIndex(N, item, i)];
+			return v;
+		}
+
+		/**
+		 * C = A x B for each item. n must be 3 or 4, here and below; other sizes are ignored.
+		 */
+		static void multiply(size_t n, size_t count, const double* A, const double* B, double* C);
+
+		/**
+		 * y = A x for each item.
+		 */
+		static void multiplyVector(size_t n, size_t count, const double* A, const double* x, double* y);
+
+		/**
+		 * Stores the determinant of each item in det, a plain array of 'count' doubles.
+		 */
+		static void determinant(size_t n, size_t count, const double* A, double* det);
+
+		/**
+		 * Computes the inverse of each item. Singular items get a zero matrix. Returns the number of singular items.
+		 */
+		static size_t inverse(size_t n, size_t count, const double* A, double* inverse);
+
+		/**
+		 * Solves A x = b for each item. Singular items get a zero vector. Returns the number of singular items.
+		 */
+		static size_t solve(size_t n, size_t count, const double* A, const double* b, double* x);
+
+	private:
+		static size_t blocks(size_t count) { return (count + LANES - 1) / LANES; }
+	};
+}
+
+#endif
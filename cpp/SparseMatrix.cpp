@@ -0,0 +1,469 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "SparseMatrix.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace LibMath
+{
+	namespace
+	{
+	/// Below this many stored elements per thread, a product isn't worth splitting.
+	const size_t MIN_NONZEROS_PER_THREAD = 128 * 1024;
+
+	/// Columns of a dense right hand side per thread, for CSC products.
+	const size_t MIN_COLUMNS_PER_THREAD = 4;
+
+	/**
+	 * Swaps the roles of the major and minor dimensions of compressed arrays: the result lists, for each minor index,
+	 * the major indices that use it. A counting sort; because majors are visited in order, the output is sorted.
+	 */
+	void transposeStructure(size_t majorSize, size_t minorSize, const std::vector<size_t>& offsets, const std::vector<uint32_t>& indices,
+		const std::vector<double>& values, std::vector<size_t>& outOffsets, std::vector<uint32_t>& outIndices, std::vector<double>& outValues)
+	{
+		outOffsets.assign(minorSize + 1, 0);
+		outIndices.resize(indices.size());
+		outValues.resize(values.size());
+
+		for (size_t k = 0; k < indices.size(); ++k)
+			++outOffsets[indices[k] + 1];
+		for (size_t i = 0; i < minorSize; ++i)
+			outOffsets[i + 1] += outOffsets[i];
+
+		std::vector<size_t> next(outOffsets.begin(), outOffsets.end() - 1);
+		for (size_t major = 0; major < majorSize; ++major)
+		{
+			for (size_t k = offsets[major]; k < offsets[major + 1]; ++k)
+			{
+				size_t slot = next[indices[k]]++;
+				outIndices[slot] = (uint32_t)major;
+				outValues[slot] = values[k];
+			}
+		}
+	}
+
+	double dot(const double* a, const double* b, size_t n)
+	{
+		double sum = (double)0.0;
+		for (size_t i = 0; i < n; ++i)
+			sum += a[i] * b[i];
+		return sum;
+	}
+
+	/// z = M^-1 r for the Jacobi preconditioner, whose inverse is stored in diagInv; z = r without one.
+	void precondition(const std::vector<double>& diagInv, const double* r, double* z, size_t n)
+	{
+		if (diagInv.empty())
+		{
+			std::copy(r, r + n, z);
+			return;
+		}
+		for (size_t i = 0; i < n; ++i)
+			z[i] = diagInv[i] * r[i];
+	}
+
+	/// Inverse of A's diagonal, with ones where the diagonal is zero.
+	std::vector<double> jacobiInverse(const SparseMatrix* A)
+	{
+		std::vector<double> diagInv(A->width());
+		for (size_t i = 0; i < diagInv.size(); ++i)
+		{
+			double d = A->get(i, i);
+			diagInv[i] = (d != (double)0.0) ? (double)1.0 / d : (double)1.0;
+		}
+		return diagInv;
+	}
+	}
+
+	SparseMatrix::SparseMatrix(void)
+	{
+		m_w = 0;
+		m_h = 0;
+		m_format = CSR;
+		m_offsets.assign(1, 0);
+	}
+
+	SparseMatrix::SparseMatrix(size_t w, size_t h, const size_t* rowIndices, const size_t* colIndices, const double* values,
+		size_t numTriplets, Format format)
+	{
+		m_w = w;
+		m_h = h;
+		m_format = format;
+
+		const size_t* major = (format == CSR) ? rowIndices : colIndices;
+		const size_t* minor = (format == CSR) ? colIndices : rowIndices;
+		size_t numMajor = majorSize();
+		size_t numMinor = minorSize();
+
+		// Bucket the triplets by minor index, then stably by major index, so each major line comes out sorted.
+		std::vector<size_t> minorOffsets(numMinor + 1, 0);
+		for (size_t k = 0; k < numTriplets; ++k)
+		{
+			// Sanity check.
+			if ((major[k] < numMajor) && (minor[k] < numMinor))
+				++minorOffsets[minor[k] + 1];
+		}
+		for (size_t i = 0; i < numMinor; ++i)
+			minorOffsets[i + 1] += minorOffsets[i];
+		std::vector<size_t> byMinor(minorOffsets[numMinor]);
+		for (size_t k = 0; k < numTriplets; ++k)
+		{
+			if ((major[k] < numMajor) && (minor[k] < numMinor))
+				byMinor[minorOffsets[minor[k]]++] = k;
+		}
+
+		m_offsets.assign(numMajor + 1, 0);
+		for (size_t k : byMinor)
+			++m_offsets[major[k] + 1];
+		for (size_t i = 0; i < numMajor; ++i)
+			m_offsets[i + 1] += m_offsets[i];
+		m_indices.resize(byMinor.size());
+		m_values.resize(byMinor.size());
+		std::vector<size_t> next(m_offsets.begin(), m_offsets.end() - 1);
+		for (size_t k : byMinor)
+		{
+			size_t slot = next[major[k]]++;
+			m_indices[slot] = (uint32_t)minor[k];
+			m_values[slot] = values[k];
+		}
+
+		// Sum duplicates, compacting in place.
+		size_t out = 0;
+		size_t begin = 0;
+		for (size_t line = 0; line < numMajor; ++line)
+		{
+			size_t end = m_offsets[line + 1];
+			size_t lineStart = out;
+			for (size_t k = begin; k < end; ++k)
+			{
+				if ((out > lineStart) && (m_indices[out - 1] == m_indices[k]))
+				{
+					m_values[out - 1] += m_values[k];
+				}
+				else
+				{
+					m_indices[out] = m_indices[k];
+					m_values[out] = m_values[k];
+					++out;
+				}
+			}
+			begin = end;
+			m_offsets[line + 1] = out;
+		}
+		m_indices.resize(out);
+		m_values.resize(out);
+	}
+
+	double SparseMatrix::get(size_t i, size_t j) const
+	{
+		size_t major = (m_format == CSR) ? i : j;
+		size_t minor = (m_format == CSR) ? j : i;
+
+		// Sanity check.
+		if ((i >= m_w) || (j >= m_h))
+			return (double)0.0;
+
+		auto first = m_indices.begin() + m_offsets[major];
+		auto last = m_indices.begin() + m_offsets[major + 1];
+		auto iter = std::lower_bound(first, last, (uint32_t)minor);
+		if ((iter != last) && (*iter == minor))
+			return m_values[iter - m_indices.begin()];
+		return (double)0.0;
+	}
+
+	SparseMatrix SparseMatrix::converted(Format format) const
+	{
+		if (format == m_format)
+			return *this;
+
+		SparseMatrix result;
+		result.m_w = m_w;
+		result.m_h = m_h;
+		result.m_format = format;
+		transposeStructure(majorSize(), minorSize(), m_offsets, m_indices, m_values, result.m_offsets, result.m_indices, result.m_values);
+		return result;
+	}
+
+	SparseMatrix SparseMatrix::transpose(void) const
+	{
+		// The arrays of A in one format are the arrays of A^T in the other.
+		SparseMatrix result;
+		result.m_w = m_h;
+		result.m_h = m_w;
+		result.m_format = m_format;
+		transposeStructure(majorSize(), minorSize(), m_offsets, m_indices, m_values, result.m_offsets, result.m_indices, result.m_values);
+		return result;
+	}
+
+	void SparseMatrix::diagonal(Vector* d) const
+	{
+		size_t n = std::min(m_w, m_h);
+
+		// Sanity check.
+		if (d->size() != n)
+			return;
+
+		for (size_t i = 0; i < n; ++i)
+			d->m_data[i] = get(i, i);
+	}
+
+	void SparseMatrix::multiply(const double* x, double* y) const
+	{
+		if (m_format == CSC)
+		{
+			// Scatter each column into y.
+			std::fill(y, y + m_w, (double)0.0);
+			for (size_t j = 0; j < m_h; ++j)
+			{
+				double xj = x[j];
+				for (size_t k = m_offsets[j]; k < m_offsets[j + 1]; ++k)
+					y[m_indices[k]] += m_values[k] * xj;
+			}
+			return;
+		}
+
+		// Each thread takes a run of rows holding about the same number of stored elements.
+		size_t numParts = std::min(Parallel::numThreads(), std::max((size_t)1, nonZeros() / MIN_NONZEROS_PER_THREAD));
+		Parallel::forRange(numParts, 1, [&](size_t firstPart, size_t lastPart) {
+			size_t rowBegin = std::lower_bound(m_offsets.begin(), m_offsets.end() - 1, nonZeros() * firstPart / numParts) - m_offsets.begin();
+			size_t rowEnd = (lastPart == numParts) ? m_w :
+				(size_t)(std::lower_bound(m_offsets.begin(), m_offsets.end() - 1, nonZeros() * lastPart / numParts) - m_offsets.begin());
+			for (size_t i = rowBegin; i < rowEnd; ++i)
+			{
+				double sum = (double)0.0;
+				for (size_t k = m_offsets[i]; k < m_offsets[i + 1]; ++k)
+					sum += m_values[k] * x[m_indices[k]];
+				y[i] = sum;
+			}
+		});
+	}
+
+	void SparseMatrix::multiply(const Vector* x, Vector* y) const
+	{
+		// Sanity check.
+		if ((x->size() != m_h) || (y->size() != m_w))
+			return;
+
+		multiply(x->m_data, y->m_data);
+	}
+
+	void SparseMatrix::multiply(const Matrix* X, Matrix* Y) const
+	{
+		// Sanity check.
+		if ((X->width() != m_h) || (Y->width() != m_w) || (Y->height() != X->height()))
+			return;
+
+		size_t numCols = X->height();
+		if (m_format == CSC)
+		{
+			// Threads take slices of the dense columns, so their scatters never touch the same element.
+			Parallel::forRange(numCols, MIN_COLUMNS_PER_THREAD, [&](size_t c0, size_t c1) {
+				for (size_t i = 0; i < m_w; ++i)
+					std::fill(Y->row(i) + c0, Y->row(i) + c1, (double)0.0);
+				for (size_t j = 0; j < m_h; ++j)
+				{
+					const double* rowX = X->row(j);
+					for (size_t k = m_offsets[j]; k < m_offsets[j + 1]; ++k)
+					{
+						double* rowY = Y->row(m_indices[k]);
+						double v = m_values[k];
+						for (size_t c = c0; c < c1; ++c)
+							rowY[c] += v * rowX[c];
+					}
+				}
+			});
+			return;
+		}
+
+		size_t work = nonZeros() * std::max((size_t)1, numCols);
+		size_t numParts = std::min(Parallel::numThreads(), std::max((size_t)1, work / MIN_NONZEROS_PER_THREAD));
+		Parallel::forRange(numParts, 1, [&](size_t firstPart, size_t lastPart) {
+			size_t rowBegin = std::lower_bound(m_offsets.begin(), m_offsets.end() - 1, nonZeros() * firstPart / numParts) - m_offsets.begin();
+			size_t rowEnd = (lastPart == numParts) ? m_w :
+				(size_t)(std::lower_bound(m_offsets.begin(), m_offsets.end() - 1, nonZeros() * lastPart / numParts) - m_offsets.begin());
+			for (size_t i = rowBegin; i < rowEnd; ++i)
+			{
+				double* rowY = Y->row(i);
+				std::fill(rowY, rowY + numCols, (double)0.0);
+				for (size_t k = m_offsets[i]; k < m_offsets[i + 1]; ++k)
+				{
+					const double* rowX = X->row(m_indices[k]);
+					double v = m_values[k];
+					for (size_t c = 0; c < numCols; ++c)
+						rowY[c] += v * rowX[c];
+				}
+			}
+		});
+	}
+
+	bool IterativeSolvers::conjugateGradient(const SparseMatrix* A, const Vector* b, Vector* x, double tolerance, size_t maxIterations,
+		bool jacobi, size_t* iterations, double* residual)
+	{
+		size_t n = A->width();
+
+		// Sanity check.
+		if ((A->height() != n) || (b->size() != n) || (x->size() != n))
+			return false;
+
+		std::vector<double> diagInv;
+		if (jacobi)
+			diagInv = jacobiInverse(A);
+		std::vector<double> r(n);
+		std::vector<double> z(n);
+		std::vector<double> p(n);
+		std::vector<double> Ap(n);
+
+		// r = b - Ax, z = M^-1 r, p = z
+		A->multiply(x->m_data, Ap.data());
+		for (size_t i = 0; i < n; ++i)
+			r[i] = b->m_data[i] - Ap[i];
+		precondition(diagInv, r.data(), z.data(), n);
+		p = z;
+
+		double bNorm = sqrt(dot(b->m_data, b->m_data, n));
+		if (bNorm == (double)0.0)
+			bNorm = (double)1.0;
+		double rz = dot(r.data(), z.data(), n);
+		double relative = sqrt(dot(r.data(), r.data(), n)) / bNorm;
+		size_t iteration = 0;
+
+		while ((relative > tolerance) && (iteration < maxIterations))
+		{
+			A->multiply(p.data(), Ap.data());
+			double pAp = dot(p.data(), Ap.data(), n);
+			if (pAp == (double)0.0)
+				break;
+			double alpha = rz / pAp;
+			for (size_t i = 0; i < n; ++i)
+			{
+				x->m_data[i] += alpha * p[i];
+				r[i] -= alpha * Ap[i];
+			}
+			++iteration;
+
+			relative = sqrt(dot(r.data(), r.data(), n)) / bNorm;
+			if (relative <= tolerance)
+				break;
+
+			precondition(diagInv, r.data(), z.data(), n);
+			double rzNext = dot(r.data(), z.data(), n);
+			double beta = rzNext / rz;
+			rz = rzNext;
+			for (size_t i = 0; i < n; ++i)
+				p[i] = z[i] + beta * p[i];
+		}
+
+		if (iterations)
+			*iterations = iteration;
+		if (residual)
+			*residual = relative;
+		return relative <= tolerance;
+	}
+
+	bool IterativeSolvers::biCGSTAB(const SparseMatrix* A, const Vector* b, Vector* x, double tolerance, size_t maxIterations,
+		bool jacobi, size_t* iterations, double* residual)
+	{
+		size_t n = A->width();
+
+		// Sanity check.
+		if ((A->height() != n) || (b->size() != n) || (x->size() != n))
+			return false;
+
+		std::vector<double> diagInv;
+		if (jacobi)
+			diagInv = jacobiInverse(A);
+		std::vector<double> r(n);
+		std::vector<double> rHat(n);
+		std::vector<double> p(n, (double)0.0);
+		std::vector<double> v(n, (double)0.0);
+		std::vector<double> pHat(n);
+		std::vector<double> s(n);
+		std::vector<double> sHat(n);
+		std::vector<double> t(n);
+
+		A->multiply(x->m_data, t.data());
+		for (size_t i = 0; i < n; ++i)
+			r[i] = b->m_data[i] - t[i];
+		rHat = r;
+
+		double bNorm = sqrt(dot(b->m_data, b->m_data, n));
+		if (bNorm == (double)0.0)
+			bNorm = (double)1.0;
+		double relative = sqrt(dot(r.data(), r.data(), n)) / bNorm;
+		double rho = (double)1.0;
+		double alpha = (double)1.0;
+		double omega = (double)1.0;
+		size_t iteration = 0;
+
+		while ((relative > tolerance) && (iteration < maxIterations))
+		{
+			double rhoNext = dot(rHat.data(), r.data(), n);
+			if (rhoNext == (double)0.0)
+				break;
+			double beta = (rhoNext / rho) * (alpha / omega);
+			rho = rhoNext;
+			for (size_t i = 0; i < n; ++i)
+				p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+			precondition(diagInv, p.data(), pHat.data(), n);
+			A->multiply(pHat.data(), v.data());
+			double rHatV = dot(rHat.data(), v.data(), n);
+			if (rHatV == (double)0.0)
+				break;
+			alpha = rho / rHatV;
+			for (size_t i = 0; i < n; ++i)
+				s[i] = r[i] - alpha * v[i];
+			++iteration;
+
+			// Converged half way through the step.
+			double sNorm = sqrt(dot(s.data(), s.data(), n)) / bNorm;
+			if (sNorm <= tolerance)
+			{
+				for (size_t i = 0; i < n; ++i)
+					x->m_data[i] += alpha * pHat[i];
+				relative = sNorm;
+				break;
+			}
+
+			precondition(diagInv, s.data(), sHat.data(), n);
+			A->multiply(sHat.data(), t.data());
+			double tt = dot(t.data(), t.data(), n);
+			omega = (tt == (double)0.0) ? (double)0.0 : dot(t.data(), s.data(), n) / tt;
+			for (size_t i = 0; i < n; ++i)
+			{
+				x->m_data[i] += alpha * pHat[i] + omega * sHat[i];
+				r[i] = s[i] - omega * t[i];
+			}
+			relative = sqrt(dot(r.data(), r.data(), n)) / bNorm;
+			if (omega == (double)0.0)
+				break;
+		}
+
+		if (iterations)
+			*iterations = iteration;
+		if (residual)
+			*residual = relative;
+		return relative <= tolerance;
+	}
+}
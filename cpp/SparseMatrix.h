@@ -0,0 +1,152 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _SPARSEMATRIX_
+#define _SPARSEMATRIX_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+#include "Matrix.h"
+#include "Vector.h"
+
+namespace LibMath
+{
+	/**
+	 * A sparse matrix in compressed sparse row (CSR) or compressed sparse column (CSC) form. width and height have the
+	 * same meaning as for Matrix: the number of rows and the number of columns.
+	 *
+	 * Products are fastest, and run in parallel, when each output element gathers from one compressed line: CSR
+	 * for A x. CSC products are parallel across the columns of a dense right hand side instead, so for a vector they
+	 * run on one thread.
+	 */
+	class SparseMatrix
+	{
+	public:
+		enum Format
+		{
+			CSR,
+			CSC
+		};
+
+		/**
+		 * An empty, 0 x 0 matrix.
+		 */
+		SparseMatrix(void);
+
+		/**
+		 * Builds a w x h matrix from coordinate (COO) triplets: element (rowIndices[k], colIndices[k]) is values[k].
+		 * Triplets may come in any order, and duplicates are summed. Indices must be less than the dimensions, and the
+		 * minor dimension (columns for CSR, rows for CSC) must fit in 32 bits.
+		 */
+		SparseMatrix(size_t w, size_t h, const size_t* rowIndices, const size_t* colIndices, const double* values,
+			size_t numTriplets, Format format = CSR);
+
+		size_t width(void) const { return m_w; }
+		size_t height(void) const { return m_h; }
+		Format format(void) const { return m_format; }
+
+		/**
+		 * Returns the number of stored elements.
+		 */
+		size_t nonZeros(void) const { return m_values.size(); }
+
+		/**
+		 * Returns element (i, j), which is zero if it isn't stored.
+		 */
+		double get(size_t i, size_t j) const;
+
+		/**
+		 * The compressed arrays: entries offsets[k] .. offsets[k+1] of indices and values belong to row k (CSR) or
+		 * column k (CSC), in increasing order of index.
+		 */
+		const std::vector<size_t>& offsets(void) const { return m_offsets; }
+		const std::vector<uint32_t>& indices(void) const { return m_indices; }
+		const std::vector<double>& values(void) const { return m_values; }
+
+		/**
+		 * Returns the same matrix in the other format.
+		 */
+		SparseMatrix converted(Format format) const;
+
+		/**
+		 * Returns the transpose, in the same format.
+		 */
+		SparseMatrix transpose(void) const;
+
+		/**
+		 * Copies the diagonal into d, which must have min(width, height) elements.
+		 */
+		void diagonal(Vector* d) const;
+
+		/**
+		 * Computes y = A x.
+		 */
+		void multiply(const Vector* x, Vector* y) const;
+
+		/**
+		 * Computes Y = A X for a dense matrix X.
+		 */
+		void multiply(const Matrix* X, Matrix* Y) const;
+
+		/**
+		 * Computes y = A x on raw arrays, for callers that manage their own storage.
+		 */
+		void multiply(const double* x, double* y) const;
+
+	private:
+		size_t                m_w;
+		size_t                m_h;
+		Format                m_format;
+		std::vector<size_t>   m_offsets;  // one more than the major dimension
+		std::vector<uint32_t> m_indices;  // minor index of each entry
+		std::vector<double>   m_values;
+
+		size_t majorSize(void) const { return (m_format == CSR) ? m_w : m_h; }
+		size_t minorSize(void) const { return (m_format == CSR) ? m_h : m_w; }
+	};
+
+	/**
+	 * Iterative solvers for Ax = b with a sparse A. x holds the initial guess on entry (zero is fine) and the solution
+	 * on return. Iteration stops once |b - Ax| <= tolerance * |b|. With 'jacobi' set, the system is preconditioned with
+	 * the inverse of A's diagonal. Work vectors are allocated once per solve; the iterations themselves don't allocate.
+	 * Each returns true if it converged, and reports the iterations used and final relative residual when asked.
+	 */
+	class IterativeSolvers
+	{
+	public:
+		/**
+		 * Preconditioned Conjugate Gradient, for symmetric positive definite A.
+		 */
+		static bool conjugateGradient(const SparseMatrix* A, const Vector* b, Vector* x, double tolerance, size_t maxIterations,
+			bool jacobi = true, size_t* iterations = NULL, double* residual = NULL);
+
+		/**
+		 * BiCGSTAB, for general (nonsymmetric) square A.
+		 */
+		static bool biCGSTAB(const SparseMatrix* A, const Vector* b, Vector* x, double tolerance, size_t maxIterations,
+			bool jacobi = true, size_t* iterations = NULL, double* residual = NULL);
+	};
+}
+
+#endif
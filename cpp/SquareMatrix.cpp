@@ -21,165 +21,148 @@
 
 #include <math.h>
 #include <iostream>
+#include <utility>
 
 #include "SquareMatrix.h"
+#include "Decomposition.h"
+#include "Gemm.h"
+#include "MatrixView.h"
 
 namespace LibMath
 {
 	SquareMatrix::SquareMatrix() : Matrix()
 	{
 		m_size = 0;
-		m_data = NULL;
 	}
 
 	SquareMatrix::SquareMatrix(size_t size) : Matrix(size, size)
 	{
 		m_size = size;
-		m_data = new double *[m_size];
-		for (auto i = 0; i < m_size; ++i)
-			m_data[i] = new double[m_size];
+	}
+
+	SquareMatrix::SquareMatrix(const SquareMatrix& B) : Matrix(B)
+	{
+		m_size = B.m_size;
+	}
+
+	SquareMatrix::SquareMatrix(SquareMatrix&& B) : Matrix(std::move(B))
+	{
+		m_size = B.m_size;
+		B.m_size = 0;
 	}
 
 	SquareMatrix::~SquareMatrix(void)
 	{
-		if (m_data != NULL)
+	}
+
+	SquareMatrix& SquareMatrix::operator=(const SquareMatrix& B)
+	{
+		Matrix::operator=(B);
+		m_size = B.m_size;
+		return *this;
+	}
+
+	SquareMatrix& SquareMatrix::operator=(SquareMatrix&& B)
+	{
+		if (this != &B)
 		{
-			for (auto i = 0; i < m_size; ++i)
-			{
-				delete m_data[i];
-				m_data[i] = NULL;
-			}
-			delete m_data;
-			m_data = NULL;
+			m_size = B.m_size;
+			B.m_size = 0;
+			Matrix::operator=(std::move(B));
 		}
+		return *this;
 	}
 
 	void SquareMatrix::print(void)
 	{
-		if (m_data != NULL)
-		{
-			for (auto i = 0; i < m_size; ++i)
-			{
-				std::cout << "[ ";
-				for (auto j = 0; j < m_size; ++j)
-				{
-					std::cout << m_data[i][j] << " ";
-				}
-				std::cout << "]" << std::endl;
-			}
-			std::cout << std::endl;
-		}
+		Matrix::print();
 	}
 
 	void SquareMatrix::multiply(const SquareMatrix* B, SquareMatrix* C)
 	{
-		// Compute C = A x B
-		for (auto i = 0; i < m_size; ++i)
-		{
-			for (auto j = 0; j < m_size; ++j)
-			{
-				C->m_data[i][j] = 0.0;
-				for (auto k = 0; k < m_size; ++k)
-				{
-					C->m_data[i][j] += m_data[i][k] * B->m_data[k][j];
-				}
-			}
-		}
+		Matrix::multiply(B, C);
 	}
 
 	void SquareMatrix::multiply(const Vector* B, Vector* C)
 	{
 		// Compute C = A x B
-		for (auto i = 0; i < m_size; ++i)
-		{
-			C->m_data[i] = 0.0;
-			for (auto j = 0; j < m_size; ++j)
-			{
-				C->m_data[i] += m_data[i][j] * B->m_data[j];
-			}
-		}
+		Gemm::multiplyVector(false, m_size, m_size, (double)1.0, m_data, m_stride, B->m_data, (double)0.0, C->m_data);
 	}
 
 	void SquareMatrix::multiply(double B)
 	{
-		for (auto i = 0; i < m_size; ++i)
-		{
-			for (auto j = 0; j < m_size; ++j)
-			{
-				m_data[i][j] *= B;
-			}
-		}
+		Matrix::multiply(B);
 	}
 
 	void SquareMatrix::subtract(const SquareMatrix* B, SquareMatrix* C)
 	{
-		for (auto i = 0; i < m_size; ++i)
-		{
-			for (auto j = 0; j < m_size; ++j)
-			{
-				C->m_data[i][j] = m_data[i][j] - B->m_data[i][j];
-			}
-		}
+		Matrix::subtract(B, C);
 	}
 
 	void SquareMatrix::subtract(double B)
 	{
-		for (auto i = 0; i < m_size; ++i)
-		{
-			for (auto j = 0; j < m_size; ++j)
-			{
-				m_data[i][j] -= B;
-			}
-		}
+		Matrix::subtract(B);
 	}
 
 	void SquareMatrix::zero(void)
 	{
-		for (auto i = 0; i < m_size; ++i)
-		{
-			for (auto j = 0; j < m_size; ++j)
-			{
-				m_data[i][j] = 0.0;
-			}
-		}
+		Matrix::zero();
 	}
 
 	void SquareMatrix::identity(void)
 	{
-		for (auto i = 0; i < m_size; ++i)
+		Matrix::zero();
+		for (size_t i = 0; i < m_size; ++i)
 		{
-			for (auto j = 0; j < m_size; ++j)
-			{
-				if (i == j)
-					m_data[i][j] = 1.0;
-				else
-					m_data[i][j] = 0.0;
-			}
+			row(i)[i] = 1.0;
 		}
 	}
 	
 	void SquareMatrix::ones(void)
 	{
-		for (auto i = 0; i < m_size; ++i)
+		for (size_t i = 0; i < m_size; ++i)
 		{
-			for (auto j = 0; j < m_size; ++j)
+			double* rowI = row(i);
+			for (size_t j = 0; j < m_size; ++j)
 			{
-				m_data[i][j] = 1.0;
+				rowI[j] = 1.0;
 			}
 		}
 	}
 	
 	double SquareMatrix::dot(const SquareMatrix* B)
 	{
-		double dot = 0.0;
-		
-		for (auto i = 0; i < m_size; ++i)
-		{
-			for (auto j = 0; j < m_size; ++j)
-			{
-				dot +=	*(m_data[i] + j * m_size) + *(B->m_data[i] + j * B->m_size);
-			}
-		}
-		return dot;
+		// Sum of the products of corresponding elements (the Frobenius inner product).
+		return LibMath::dot(view(), B->view());
+	}
+
+	double SquareMatrix::determinant(void) const
+	{
+		LUDecomposition lu;
+		lu.factor(this);
+		return lu.determinant();
+	}
+
+	bool SquareMatrix::inverse(SquareMatrix* result) const
+	{
+		LUDecomposition lu;
+		return lu.factor(this) && lu.inverse(result);
+	}
+
+	bool SquareMatrix::solve(const Vector* b, Vector* x) const
+	{
+		LUDecomposition lu;
+		return lu.factor(this) && lu.solve(b, x);
+	}
+
+	SquareMatrix operator*(const SquareMatrix& A, const SquareMatrix& B)
+	{
+		// Sanity check.
+		if (A.size() != B.size())
+			return SquareMatrix();
+
+		SquareMatrix C(A.size());
+		A.Matrix::multiply(&B, &C);
+		return C;
 	}
 }
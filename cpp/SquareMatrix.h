@@ -31,9 +31,45 @@ namespace LibMath
 	class SquareMatrix : public Matrix
 	{
 	public:
+		/**
+		 * An empty, 0 x 0 matrix.
+		 */
+		SquareMatrix();
 		SquareMatrix(size_t size);
+
+		/**
+		 * Copies are deep; moves take the other matrix's storage in O(1) and leave it empty.
+		 */
+		SquareMatrix(const SquareMatrix& B);
+		SquareMatrix(SquareMatrix&& B);
+
+		/**
+		 * Allocates a matrix of the expression's dimensions and evaluates the expression into it (see Expression.h).
+		 * An expression that isn't square gives an empty matrix.
+		 */
+		template <typename E>
+		SquareMatrix(const Expression<E>& expression) : Matrix(expression)
+		{
+			if (m_w != m_h)
+				release();
+			m_size = m_w;
+		}
+
 		virtual ~SquareMatrix(void);
 
+		SquareMatrix& operator=(const SquareMatrix& B);
+		SquareMatrix& operator=(SquareMatrix&& B);
+
+		/**
+		 * Evaluates an elementwise expression into this matrix; see Matrix::operator=.
+		 */
+		template <typename E>
+		SquareMatrix& operator=(const Expression<E>& expression)
+		{
+			Matrix::operator=(expression);
+			return *this;
+		}
+
 		/**
 		 * Prints the matrix to standard out. Intended for testing and debugging.
 		 */
@@ -44,8 +80,10 @@ namespace LibMath
 		 */		
 		size_t size(void) const { return m_size; }
 
+		using Matrix::multiply;
+
 		/**
-		 * Returns C = A x B, where A, B, and C are matrices.
+		 * Returns C = A x B, where A, B, and C are matrices. C must not be A or B.
 		 */
 		void multiply(const SquareMatrix* B, SquareMatrix* C);
 
@@ -89,12 +127,30 @@ namespace LibMath
 		 */
 		double dot(const SquareMatrix* B);
 
-	protected:
-		size_t   m_size;
+		/**
+		 * Returns the determinant, from an LU decomposition. To solve several systems with the same matrix, keep an
+		 * LUDecomposition (see Decomposition.h) instead.
+		 */
+		double determinant(void) const;
+
+		/**
+		 * Computes the inverse. Returns false if the matrix is singular.
+		 */
+		bool inverse(SquareMatrix* result) const;
+
+		/**
+		 * Solves Ax = b. Returns false if the matrix is singular.
+		 */
+		bool solve(const Vector* b, Vector* x) const;
 
 	protected:
-		SquareMatrix();
+		size_t   m_size;
 	};
+
+	/**
+	 * Returns A x B by value.
+	 */
+	SquareMatrix operator*(const SquareMatrix& A, const SquareMatrix& B);
 }
 
 #endif
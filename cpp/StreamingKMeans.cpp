@@ -0,0 +1,245 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "StreamingKMeans.h"
+#include "KMeans.h"
+
+#include <string.h>
+
+namespace LibMath
+{
+	static inline double squaredDistance(const double* pt1, const double* pt2, size_t dimensions)
+	{
+		double sum = (double)0.0;
+
+		for (size_t i = 0; i < dimensions; ++i)
+		{
+			double diff = pt1[i] - pt2[i];
+			sum += diff * diff;
+		}
+		return sum;
+	}
+
+	IncrementalKMeans::IncrementalKMeans(size_t k, size_t dimensions)
+	{
+		m_k = k;
+		m_dimensions = dimensions;
+		m_numSeeded = 0;
+		m_centroids = new double[k * dimensions];
+		m_counts = new double[k];
+		reset();
+	}
+
+	IncrementalKMeans::~IncrementalKMeans(void)
+	{
+		delete[] m_centroids;
+		delete[] m_counts;
+	}
+
+	void IncrementalKMeans::setCentroids(const double* centroids)
+	{
+		memcpy(m_centroids, centroids, sizeof(double) * m_k * m_dimensions);
+		memset(m_counts, 0, sizeof(double) * m_k);
+		m_numSeeded = m_k;
+	}
+
+	bool IncrementalKMeans::setCentroidsKMeansPlusPlus(const double* data, size_t numPoints, Random& rng)
+	{
+		if (!KMeans::kMeansPlusPlusCentroids(data, NULL, numPoints, m_dimensions, m_k, rng, m_centroids))
+		{
+			return false;
+		}
+		memset(m_counts, 0, sizeof(double) * m_k);
+		m_numSeeded = m_k;
+		return true;
+	}
+
+	void IncrementalKMeans::reset(void)
+	{
+		memset(m_centroids, 0, sizeof(double) * m_k * m_dimensions);
+		memset(m_counts, 0, sizeof(double) * m_k);
+		m_numSeeded = 0;
+	}
+
+	bool IncrementalKMeans::seed(const double* point)
+	{
+		if (m_numSeeded >= m_k)
+		{
+			return false;
+		}
+
+		// Duplicate seeds would leave a cluster that can never win a point, so skip them.
+		for (size_t clusterIndex = 0; clusterIndex < m_numSeeded; ++clusterIndex)
+		{
+			if (squaredDistance(point, m_centroids + clusterIndex * m_dimensions, m_dimensions) == (double)0.0)
+			{
+				return false;
+			}
+		}
+
+		memcpy(m_centroids + m_numSeeded * m_dimensions, point, sizeof(double) * m_dimensions);
+		m_counts[m_numSeeded] = (double)1.0;
+		++m_numSeeded;
+		return true;
+	}
+
+	size_t IncrementalKMeans::nearest(const double* point, double* distance) const
+	{
+		size_t bestIndex = 0;
+		double bestDistance = squaredDistance(point, m_centroids, m_dimensions);
+
+		for (size_t clusterIndex = 1; clusterIndex < m_k; ++clusterIndex)
+		{
+			double temp = squaredDistance(point, m_centroids + clusterIndex * m_dimensions, m_dimensions);
+			if (temp < bestDistance)
+			{
+				bestIndex = clusterIndex;
+				bestDistance = temp;
+			}
+		}
+		if (distance)
+		{
+			*distance = bestDistance;
+		}
+		return bestIndex;
+	}
+
+	size_t IncrementalKMeans::label(const double* point) const
+	{
+		if (!isInitialized())
+		{
+			return (size_t)-1;
+		}
+		return nearest(point, NULL);
+	}
+
+	void IncrementalKMeans::label(const double* data, size_t numPoints, size_t* tags) const
+	{
+		for (size_t dataIndex = 0; dataIndex < numPoints; ++dataIndex)
+		{
+			tags[dataIndex] = label(data + dataIndex * m_dimensions);
+		}
+	}
+
+	MiniBatchKMeans::MiniBatchKMeans(size_t k, size_t dimensions) : IncrementalKMeans(k, dimensions)
+	{
+		m_batchSums = new double[k * dimensions];
+		m_batchCounts = new double[k];
+	}
+
+	MiniBatchKMeans::~MiniBatchKMeans(void)
+	{
+		delete[] m_batchSums;
+		delete[] m_batchCounts;
+	}
+
+	void MiniBatchKMeans::addBatch(const double* data, size_t numPoints)
+	{
+		// Use the leading points as seeds, if we don't have a full set of centroids yet.
+		size_t dataIndex = 0;
+		while ((dataIndex < numPoints) && !isInitialized())
+		{
+			seed(data + dataIndex * m_dimensions);
+			++dataIndex;
+		}
+
+		// Assignment step. Every point in the batch is measured against the centroids as they were at the start of the
+		// batch. Only the per-cluster sums are kept, rather than per-point tags, so memory stays O(k * dimensions).
+		memset(m_batchSums, 0, sizeof(double) * m_k * m_dimensions);
+		memset(m_batchCounts, 0, sizeof(double) * m_k);
+		for (; dataIndex < numPoints; ++dataIndex)
+		{
+			const double* point = data + dataIndex * m_dimensions;
+			size_t clusterIndex = nearest(point, NULL);
+			double* sum = m_batchSums + clusterIndex * m_dimensions;
+
+			for (size_t i = 0; i < m_dimensions; ++i)
+			{
+				sum[i] += point[i];
+			}
+			m_batchCounts[clusterIndex] += (double)1.0;
+		}
+
+		// Update step. Taking one gradient step per point with a learning rate of 1 / count is the same as folding
+		// the batch sum into the running mean, so do that in one go.
+		for (size_t clusterIndex = 0; clusterIndex < m_k; ++clusterIndex)
+		{
+			double batchCount = m_batchCounts[clusterIndex];
+			if (batchCount == (double)0.0)
+			{
+				continue;
+			}
+
+			double* centroid = m_centroids + clusterIndex * m_dimensions;
+			const double* sum = m_batchSums + clusterIndex * m_dimensions;
+
+			m_counts[clusterIndex] += batchCount;
+			double learningRate = (double)1.0 / m_counts[clusterIndex];
+
+			for (size_t i = 0; i < m_dimensions; ++i)
+			{
+				centroid[i] += learningRate * (sum[i] - batchCount * centroid[i]);
+			}
+		}
+	}
+
+	StreamingKMeans::StreamingKMeans(size_t k, size_t dimensions, double minLearningRate) : IncrementalKMeans(k, dimensions)
+	{
+		m_minLearningRate = minLearningRate;
+	}
+
+	StreamingKMeans::~StreamingKMeans(void)
+	{
+	}
+
+	size_t StreamingKMeans::addPoint(const double* point)
+	{
+		if (!isInitialized())
+		{
+			seed(point);
+			return (size_t)-1;
+		}
+
+		size_t clusterIndex = nearest(point, NULL);
+		double* centroid = m_centroids + clusterIndex * m_dimensions;
+
+		m_counts[clusterIndex] += (double)1.0;
+		double learningRate = (double)1.0 / m_counts[clusterIndex];
+		if (learningRate < m_minLearningRate)
+		{
+			learningRate = m_minLearningRate;
+		}
+
+		for (size_t i = 0; i < m_dimensions; ++i)
+		{
+			centroid[i] += learningRate * (point[i] - centroid[i]);
+		}
+		return clusterIndex;
+	}
+
+	void StreamingKMeans::addBatch(const double* data, size_t numPoints)
+	{
+		for (size_t dataIndex = 0; dataIndex < numPoints; ++dataIndex)
+		{
+			addPoint(data + dataIndex * m_dimensions);
+		}
+	}
+}
@@ -0,0 +1,164 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _STREAMINGKMEANS_
+#define _STREAMINGKMEANS_
+
+#include <stdlib.h>
+
+#include "Random.h"
+
+namespace LibMath
+{
+	/**
+	 * Base class for the incremental K Means models. Holds the k centroids (stored row-major,
+	 * 'dimensions' values per centroid) and the number of points that have been assigned to each.
+	 * Memory use is O(k * dimensions), regardless of how many points have been consumed.
+	 */
+	class IncrementalKMeans
+	{
+	public:
+		IncrementalKMeans(size_t k, size_t dimensions);
+		virtual ~IncrementalKMeans(void);
+
+		/**
+		 * Returns the number of clusters.
+		 */
+		size_t k(void) const { return m_k; }
+
+		/**
+		 * Returns the number of values in each point.
+		 */
+		size_t dimensions(void) const { return m_dimensions; }
+
+		/**
+		 * Returns TRUE once all k centroids have been seeded.
+		 */
+		bool isInitialized(void) const { return m_numSeeded == m_k; }
+
+		/**
+		 * Returns the current centroids, an array of length k * dimensions. May be called at any time.
+		 */
+		const double* centroids(void) const { return m_centroids; }
+
+		/**
+		 * Returns the number of points that have been assigned to the specified cluster.
+		 */
+		double count(size_t cluster) const { return m_counts[cluster]; }
+
+		/**
+		 * Sets the initial centroids, overriding any points seen so far. 'centroids' is of length k * dimensions.
+		 */
+		void setCentroids(const double* centroids);
+
+		/**
+		 * Sets the initial centroids by running k-means++ over a sample of points (such as the first batch).
+		 * Returns FALSE if the sample has fewer than k points.
+		 */
+		bool setCentroidsKMeansPlusPlus(const double* data, size_t numPoints, Random& rng);
+
+		/**
+		 * Discards the centroids and counts.
+		 */
+		void reset(void);
+
+		/**
+		 * Returns the index of the centroid closest to the given point, or (size_t)-1 if the model has not been initialized.
+		 */
+		size_t label(const double* point) const;
+
+		/**
+		 * Labels each of the 'numPoints' points in 'data' against the current centroids, writing the results to 'tags'.
+		 */
+		void label(const double* data, size_t numPoints, size_t* tags) const;
+
+		/**
+		 * Updates the model with a batch of 'numPoints' points, stored row-major in 'data'.
+		 */
+		virtual void addBatch(const double* data, size_t numPoints) = 0;
+
+	protected:
+		size_t  m_k;
+		size_t  m_dimensions;
+		size_t  m_numSeeded;
+		double* m_centroids;
+		double* m_counts;
+
+		/**
+		 * Uses the point as a centroid, if we're still looking for them. Returns TRUE if the point was consumed.
+		 */
+		bool seed(const double* point);
+
+		/**
+		 * Returns the index of the nearest centroid and, optionally, the squared distance to it.
+		 */
+		size_t nearest(const double* point, double* distance) const;
+
+	private:
+		IncrementalKMeans(const IncrementalKMeans&);
+		IncrementalKMeans& operator=(const IncrementalKMeans&);
+	};
+
+	/**
+	 * Mini-batch K Means (Sculley, "Web-Scale K-Means Clustering", 2010).
+	 * Each batch is assigned against the centroids as they were at the start of the batch, then each centroid
+	 * takes a gradient step towards its assigned points with a per-centroid learning rate of 1 / count.
+	 */
+	class MiniBatchKMeans : public IncrementalKMeans
+	{
+	public:
+		MiniBatchKMeans(size_t k, size_t dimensions);
+		virtual ~MiniBatchKMeans(void);
+
+		virtual void addBatch(const double* data, size_t numPoints);
+
+	private:
+		double* m_batchSums;
+		double* m_batchCounts;
+	};
+
+	/**
+	 * Online (MacQueen style) K Means. Each point is assigned to its nearest centroid, which is then moved towards it
+	 * with a learning rate of 1 / count. Setting 'minLearningRate' above zero keeps the model adapting to drift in an
+	 * unbounded stream, instead of converging on the all-time mean.
+	 */
+	class StreamingKMeans : public IncrementalKMeans
+	{
+	public:
+		StreamingKMeans(size_t k, size_t dimensions, double minLearningRate = 0.0);
+		virtual ~StreamingKMeans(void);
+
+		/**
+		 * Updates the model with a single point. Returns the cluster the point was assigned to, or (size_t)-1 if
+		 * the point was used to seed a centroid.
+		 */
+		size_t addPoint(const double* point);
+
+		virtual void addBatch(const double* data, size_t numPoints);
+
+	private:
+		double m_minLearningRate;
+	};
+}
+
+#endif
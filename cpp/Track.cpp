@@ -0,0 +1,137 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Track.h"
+#include "Distance.h"
+
+namespace LibMath
+{
+	void Track::process(const double* timestamps, const double* lat, const double* lon, const double* alt, size_t numPoints, size_t paceWindow,
+		double* cumulativeDistance, double* speed, double* pace)
+	{
+		// Sanity check.
+		if (numPoints == 0)
+		{
+			return;
+		}
+		if (paceWindow == 0)
+		{
+			paceWindow = 1;
+		}
+
+		const size_t BLOCK_SIZE = 512;
+
+		cumulativeDistance[0] = (double)0.0;
+		if (speed)
+			speed[0] = (double)0.0;
+		if (pace)
+			pace[0] = (double)0.0;
+
+		// Work through the track a block at a time. Each block's segment lengths go straight into the output, and are
+		// turned into running totals, speeds and paces while they are still in cache.
+		for (size_t blockStart = 0; blockStart + 1 < numPoints; blockStart += BLOCK_SIZE)
+		{
+			size_t blockEnd = (numPoints - 1 - blockStart > BLOCK_SIZE) ? blockStart + BLOCK_SIZE : numPoints - 1;
+			Distance::haversineDistancesConsecutive(lat + blockStart, lon + blockStart, alt ? alt + blockStart : NULL,
+				blockEnd - blockStart + 1, cumulativeDistance + blockStart + 1);
+
+			for (size_t i = blockStart + 1; i <= blockEnd; ++i)
+			{
+				double segment = cumulativeDistance[i];
+				cumulativeDistance[i] = cumulativeDistance[i - 1] + segment;
+
+				if (speed)
+				{
+					double elapsed = timestamps[i] - timestamps[i - 1];
+					speed[i] = (elapsed > (double)0.0) ? segment / elapsed : speed[i - 1];
+				}
+				if (pace)
+				{
+					size_t windowStart = (i > paceWindow) ? i - paceWindow : 0;
+					double windowDistance = cumulativeDistance[i] - cumulativeDistance[windowStart];
+					double windowTime = timestamps[i] - timestamps[windowStart];
+					pace[i] = (windowDistance > (double)0.0) ? windowTime / windowDistance : (double)0.0;
+				}
+			}
+		}
+	}
+
+	LiveTrack::LiveTrack(size_t paceWindow)
+	{
+		m_paceWindow = (paceWindow == 0) ? 1 : paceWindow;
+		m_windowTimes = new double[m_paceWindow + 1];
+		m_windowDistances = new double[m_paceWindow + 1];
+		reset();
+	}
+
+	LiveTrack::~LiveTrack(void)
+	{
+		delete[] m_windowTimes;
+		delete[] m_windowDistances;
+	}
+
+	void LiveTrack::reset(void)
+	{
+		m_numPoints = 0;
+		m_lastTimestamp = (double)0.0;
+		m_lastLat = (double)0.0;
+		m_lastLon = (double)0.0;
+		m_lastAlt = (double)0.0;
+		m_lastCosLat = (double)1.0;
+		m_cumulativeDistance = (double)0.0;
+		m_speed = (double)0.0;
+		m_pace = (double)0.0;
+	}
+
+	void LiveTrack::addPoint(double timestamp, double lat, double lon, double alt)
+	{
+		// The cos(latitude) of each point is computed once and reused for the next segment.
+		double cosLat = Distance::cosLatitude(lat);
+
+		if (m_numPoints > 0)
+		{
+			double segment = Distance::haversineDistanceCosLat(m_lastLat, m_lastLon, m_lastAlt, m_lastCosLat, lat, lon, alt, cosLat);
+			double elapsed = timestamp - m_lastTimestamp;
+
+			m_cumulativeDistance += segment;
+			if (elapsed > (double)0.0)
+			{
+				m_speed = segment / elapsed;
+			}
+		}
+
+		// Pace over the window, measured against the oldest point still in the ring buffer.
+		size_t slot = m_numPoints % (m_paceWindow + 1);
+		m_windowTimes[slot] = timestamp;
+		m_windowDistances[slot] = m_cumulativeDistance;
+		size_t oldest = (m_numPoints >= m_paceWindow) ? (m_numPoints - m_paceWindow) % (m_paceWindow + 1) : 0;
+		double windowDistance = m_cumulativeDistance - m_windowDistances[oldest];
+		double windowTime = timestamp - m_windowTimes[oldest];
+		m_pace = (windowDistance > (double)0.0) ? windowTime / windowDistance : (double)0.0;
+
+		m_lastTimestamp = timestamp;
+		m_lastLat = lat;
+		m_lastLon = lon;
+		m_lastAlt = alt;
+		m_lastCosLat = cosLat;
+		++m_numPoints;
+	}
+}
@@ -0,0 +1,110 @@
+// by Michael J. Simms
+// Copyright (c) 2026 Michael J. Simms
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#ifndef _TRACK_
+#define _TRACK_
+
+#include <stdlib.h>
+
+namespace LibMath
+{
+	/**
+	 * Turns a recorded GPS track (timestamps in seconds, latitude/longitude in degrees, altitude in meters) into
+	 * cumulative distance (meters), instantaneous speed (meters per second) and smoothed pace (seconds per meter).
+	 * Distances are the same as Distance::haversineDistance between consecutive points.
+	 */
+	class Track
+	{
+	public:
+		/**
+		 * Processes a whole track in one pass, a block of points at a time. 'alt' may be NULL, meaning zero altitude.
+		 * Writes 'numPoints' values to each of 'cumulativeDistance', 'speed' and 'pace'; 'speed' and 'pace' may be NULL
+		 * if they aren't wanted.
+		 * Speed is the speed over the segment ending at each point (the previous speed is kept if no time has passed).
+		 * Pace is computed over the last 'paceWindow' segments, and is zero until the track has moved.
+		 * No scratch memory is used: the segment lengths are written to 'cumulativeDistance' and summed in place.
+		 */
+		static void process(const double* timestamps, const double* lat, const double* lon, const double* alt, size_t numPoints, size_t paceWindow,
+			double* cumulativeDistance, double* speed, double* pace);
+	};
+
+	/**
+	 * Streaming form of Track::process, for live tracking. Points are added one at a time and the current values can be
+	 * read back after each one. Memory use depends only on the pace window.
+	 */
+	class LiveTrack
+	{
+	public:
+		LiveTrack(size_t paceWindow);
+		virtual ~LiveTrack(void);
+
+		/**
+		 * Adds the next point of the track.
+		 */
+		void addPoint(double timestamp, double lat, double lon, double alt);
+
+		/**
+		 * Forgets all of the points added so far.
+		 */
+		void reset(void);
+
+		/**
+		 * Returns the number of points added so far.
+		 */
+		size_t numPoints(void) const { return m_numPoints; }
+
+		/**
+		 * Returns the distance covered so far, in meters.
+		 */
+		double cumulativeDistance(void) const { return m_cumulativeDistance; }
+
+		/**
+		 * Returns the speed over the latest segment, in meters per second.
+		 */
+		double speed(void) const { return m_speed; }
+
+		/**
+		 * Returns the pace over the last 'paceWindow' segments, in seconds per meter.
+		 */
+		double pace(void) const { return m_pace; }
+
+	private:
+		size_t  m_paceWindow;
+		size_t  m_numPoints;
+		double  m_lastTimestamp;
+		double  m_lastLat;
+		double  m_lastLon;
+		double  m_lastAlt;
+		double  m_lastCosLat;
+		double  m_cumulativeDistance;
+		double  m_speed;
+		double  m_pace;
+		double* m_windowTimes;     // ring buffer of the last paceWindow + 1 timestamps
+		double* m_windowDistances; // ring buffer of the matching cumulative distances
+
+		LiveTrack(const LiveTrack&);
+		LiveTrack& operator=(const LiveTrack&);
+	};
+}
+
+#endif
@@ -27,12 +27,63 @@
 
 namespace LibMath
 {
+	Vector::Vector(void)
+	{
+		m_size = 0;
+		m_data = NULL;
+	}
+
 	Vector::Vector(size_t size)
 	{
 		m_size = size;
 		m_data = new double[m_size];
 	}
 
+	Vector::Vector(const Vector& B)
+	{
+		m_size = B.m_size;
+		m_data = new double[m_size];
+		if (m_size > 0)
+			memcpy((void *)m_data, (void *)B.m_data, sizeof(double) * m_size);
+	}
+
+	Vector::Vector(Vector&& B)
+	{
+		m_size = B.m_size;
+		m_data = B.m_data;
+		B.m_size = 0;
+		B.m_data = NULL;
+	}
+
+	Vector& Vector::operator=(const Vector& B)
+	{
+		if (this != &B)
+		{
+			if (m_size != B.m_size)
+			{
+				delete[] m_data;
+				m_size = B.m_size;
+				m_data = new double[m_size];
+			}
+			if (m_size > 0)
+				memcpy((void *)m_data, (void *)B.m_data, sizeof(double) * m_size);
+		}
+		return *this;
+	}
+
+	Vector& Vector::operator=(Vector&& B)
+	{
+		if (this != &B)
+		{
+			delete[] m_data;
+			m_size = B.m_size;
+			m_data = B.m_data;
+			B.m_size = 0;
+			B.m_data = NULL;
+		}
+		return *this;
+	}
+
 	Vector::~Vector(void)
 	{
 		if (m_data != NULL)
@@ -62,8 +113,8 @@ namespace LibMath
 	void Vector::subtract(const Vector* B, Vector* C)
 	{
 		// Compute C = A - B
-		for (auto i = 0; i < m_size; ++i)
-			C[i] = m_data[i] - B->m_data[i];
+		for (size_t i = 0; i < m_size; ++i)
+			C->m_data[i] = m_data[i] - B->m_data[i];
 	}
 
 	double Vector::dot(const Vector* B)
@@ -25,20 +25,78 @@
 #define _VECTOR_
 
 #include <stdlib.h>
+#include "Expression.h"
 
 namespace LibMath
 {
 	class Vector
 	{
 	public:
-		Vector(size_t size);
+		/**
+		 * An empty vector, of size zero.
+		 */
+		Vector(void);
+		explicit Vector(size_t size);
+
+		/**
+		 * Copies are deep; moves take the other vector's storage in O(1) and leave it empty.
+		 */
+		Vector(const Vector& B);
+		Vector(Vector&& B);
+
+		/**
+		 * Allocates a vector of the expression's size and evaluates the expression into it (see Expression.h).
+		 */
+		template <typename E>
+		Vector(const Expression<E>& expression) : m_data(NULL), m_size(0)
+		{
+			m_size = expression.derived().width();
+			m_data = new double[m_size];
+			*this = expression;
+		}
+
 		virtual ~Vector(void);
 
+		Vector& operator=(const Vector& B);
+		Vector& operator=(Vector&& B);
+
 		/**
 		 * Returns the number of elements in the vector.
 		 */		
 		size_t size(void) const { return m_size; }
 
+		/**
+		 * Evaluates an elementwise expression (see Expression.h) into this vector in one pass. The expression must have
+		 * the same size; otherwise the vector is left alone.
+		 */
+		template <typename E>
+		Vector& operator=(const Expression<E>& expression)
+		{
+			static_assert(E::rank == 1, "Only vector expressions can be assigned to a vector.");
+			const E& e = expression.derived();
+
+			// Sanity check.
+			if (!e.conforms(m_size, 1))
+				return *this;
+
+			// As for Matrix, groups of four so that the loop vectorizes at -O2.
+			size_t i = 0;
+			for (; i + 4 <= m_size; i += 4)
+			{
+				double v0 = e(i);
+				double v1 = e(i + 1);
+				double v2 = e(i + 2);
+				double v3 = e(i + 3);
+				m_data[i] = v0;
+				m_data[i + 1] = v1;
+				m_data[i + 2] = v2;
+				m_data[i + 3] = v3;
+			}
+			for (; i < m_size; ++i)
+				m_data[i] = e(i);
+			return *this;
+		}
+
 		/**
 		 * Returns a copy of vector B in vector A.
 		 */
@@ -19,22 +19,41 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <stdint.h>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "BigInt.h"
+#include "BKTree.h"
 #include "Calculus.h"
+#include "DBSCAN.h"
+#include "Decomposition.h"
+#include "FixedMatrix.h"
 #include "Distance.h"
+#include "GeoIndex.h"
 #include "Graphics.h"
+#include "Parallel.h"
 #include "KMeans.h"
+#include "MatrixView.h"
 #include "Peaks.h"
+#include "Polyline.h"
 #include "Powers.h"
 #include "Prime.h"
+#include "Random.h"
 #include "Signals.h"
+#include "SmallMatrixBatch.h"
+#include "SparseMatrix.h"
 #include "SquareMatrix.h"
 #include "Statistics.h"
+#include "Track.h"
+#include "StreamingKMeans.h"
 #include "Vector.h"
 
 typedef std::vector<double> NumVec;
@@ -80,21 +99,35 @@ void vectorTests()
 	std::cout << "Vector Tests:" << std::endl;
 	std::cout << "-------------" << std::endl;
 
-	LibMath::Vector* v1 = new LibMath::Vector(3);
-	LibMath::Vector* v2 = new LibMath::Vector(3);
+	LibMath::Vector v1(3);
+	LibMath::Vector v2(3);
 
-	v1->m_data[0] = 1; v1->m_data[1] = 2; v1->m_data[2] = 3;
-	v2->m_data[0] = 1; v2->m_data[1] = 2; v2->m_data[2] = 3;
+	v1.m_data[0] = 1; v1.m_data[1] = 2; v1.m_data[2] = 3;
+	v2.m_data[0] = 1; v2.m_data[1] = 2; v2.m_data[2] = 3;
 	std::cout << "v1:" << std::endl;
-	v1->print();
+	v1.print();
 	std::cout << "v2:" << std::endl;
-	v2->print();
-	std::cout << "v1 x v2 = " << v1->multiply(v2) << std::endl;
-	std::cout << "v1 dot v2 = " << v1->dot(v2) << std::endl;
-	std::cout << "length of v1 = " << v1->length() << std::endl;
+	v2.print();
+	std::cout << "v1 x v2 = " << v1.multiply(&v2) << std::endl;
+	std::cout << "v1 dot v2 = " << v1.dot(&v2) << std::endl;
+	std::cout << "length of v1 = " << v1.length() << std::endl;
 
-	delete v1;
-	delete v2;
+	LibMath::Vector difference(3);
+	v1.subtract(&v2, &difference);
+	assert(difference.m_data[0] == 0.0 && difference.m_data[2] == 0.0);
+
+	// Copies are deep, moves steal the storage, and results can be returned by value.
+	LibMath::Vector copied(v1);
+	copied.m_data[0] = 10.0;
+	assert(v1.m_data[0] == 1.0);
+	const double* storage = copied.m_data;
+	LibMath::Vector moved(std::move(copied));
+	assert(moved.m_data == storage && copied.size() == 0);
+	(void)storage;
+	LibMath::Vector sum = v1 + v2 * 2.0;
+	assert(sum.size() == 3 && sum.m_data[2] == 9.0);
+	sum = std::move(moved);
+	assert(sum.m_data == storage);
 }
 
 void squareMatrixTests()
@@ -102,28 +135,593 @@ void squareMatrixTests()
 	std::cout << "Square Matrix Tests:" << std::endl;
 	std::cout << "--------------------" << std::endl;
 
-	LibMath::SquareMatrix* m = new LibMath::SquareMatrix(5);
-	if (m)
+	LibMath::SquareMatrix m(5);
+	m.identity();
+	std::cout << "Identity matrix:" << std::endl;
+	m.print();
+
+	m.zero();
+	std::cout << "Zero matrix:" << std::endl;
+	m.print();
+	m.ones();
+	std::cout << "Ones matrix:" << std::endl;
+	m.print();
+	m.multiply(2.0);
+	std::cout << "Ones matrix multiplied by 2.0:" << std::endl;
+	m.print();
+
+	// Value semantics: deep copies, O(1) moves, and products returned by value.
+	LibMath::SquareMatrix twos(m);
+	m.zero();
+	assert(twos.get(4, 4) == 2.0 && twos.size() == 5);
+	const double* twosStorage = twos.row(0);
+	LibMath::SquareMatrix stolen(std::move(twos));
+	assert(stolen.row(0) == twosStorage && twos.size() == 0 && twos.width() == 0);
+	m = stolen;
+	assert(m.get(0, 3) == 2.0 && m.row(0) != twosStorage);
+	(void)twosStorage;
+	LibMath::SquareMatrix squared = m * stolen;
+	assert(squared.size() == 5 && squared.get(1, 2) == 20.0);
+	LibMath::SquareMatrix shifted = squared - 1.0;
+	assert(shifted.get(1, 2) == 19.0);
+	LibMath::Matrix tall(7, 5);
+	tall.zero();
+	tall.set(6, 4, 1.0);
+	LibMath::Matrix tallProduct = tall * squared;
+	assert(tallProduct.width() == 7 && tallProduct.height() == 5 && tallProduct.get(6, 0) == 20.0);
+	assert((squared * tall).width() == 0);
+	LibMath::Vector ones(5);
+	for (size_t i = 0; i < 5; ++i)
+		ones.m_data[i] = 1.0;
+	LibMath::Vector rowSums = tall * ones;
+	assert(rowSums.size() == 7 && rowSums.m_data[6] == 1.0 && rowSums.m_data[0] == 0.0);
+
+	// Storage is one aligned block, with each row padded to a 64 byte boundary.
+	LibMath::SquareMatrix a(5);
+	LibMath::SquareMatrix b(5);
+	LibMath::SquareMatrix c(5);
+	assert(a.stride() == 8);
+	for (size_t i = 0; i < 5; ++i)
+	{
+		assert(((uintptr_t)a.row(i) % 64) == 0);
+		for (size_t j = 0; j < 5; ++j)
+		{
+			a.set(i, j, (double)(i * 5 + j));
+			b.set(i, j, (i == j) ? 2.0 : 0.0);
+		}
+	}
+	a.multiply(&b, &c);
+	assert(c.get(3, 4) == 2.0 * a.get(3, 4));
+	assert(a.dot(&b) == 2.0 * (0.0 + 6.0 + 12.0 + 18.0 + 24.0));
+
+	// Matrices don't have to be square.
+	LibMath::Matrix wide(2, 11);
+	wide.zero();
+	wide.set(1, 10, 3.0);
+	wide.subtract(1.0);
+	assert(wide.stride() == 16 && wide.get(1, 10) == 2.0 && wide.get(0, 0) == -1.0);
+
+	// Large and non-square products go through the packed GEMM kernel; check them against the definition.
+	LibMath::Random rng(42);
+	LibMath::Matrix lhs(37, 300);
+	LibMath::Matrix rhs(300, 45);
+	LibMath::Matrix product(37, 45);
+	for (size_t i = 0; i < 300; ++i)
+	{
+		for (size_t j = 0; j < 45; ++j)
+			rhs.set(i, j, rng.nextDouble() - 0.5);
+		for (size_t j = 0; j < 37; ++j)
+			lhs.set(j, i, rng.nextDouble() - 0.5);
+	}
+	lhs.multiply(&rhs, &product);
+	for (size_t i = 0; i < 37; ++i)
+	{
+		for (size_t j = 0; j < 45; ++j)
+		{
+			double expected = 0.0;
+			for (size_t k = 0; k < 300; ++k)
+				expected += lhs.get(i, k) * rhs.get(k, j);
+			assert(fabs(product.get(i, j) - expected) < 1e-12);
+		}
+	}
+	LibMath::SquareMatrix big(130);
+	LibMath::SquareMatrix bigIdentity(130);
+	LibMath::SquareMatrix bigProduct(130);
+	for (size_t i = 0; i < 130; ++i)
+		for (size_t j = 0; j < 130; ++j)
+			big.set(i, j, rng.nextDouble());
+	bigIdentity.identity();
+	big.multiply(&bigIdentity, &bigProduct);
+	for (size_t i = 0; i < 130; ++i)
+		for (size_t j = 0; j < 130; ++j)
+			assert(bigProduct.get(i, j) == big.get(i, j));
+
+	// Elementwise expressions are evaluated in one pass on assignment, and may use the target as an operand.
+	LibMath::Matrix ea(3, 6);
+	LibMath::Matrix eb(3, 6);
+	LibMath::Matrix ec(3, 6);
+	for (size_t i = 0; i < 3; ++i)
+	{
+		for (size_t j = 0; j < 6; ++j)
+		{
+			ea.set(i, j, (double)(i + j));
+			eb.set(i, j, (double)(i * j));
+		}
+	}
+	ec = 2.0 * ea - eb + 1.0;
+	assert(ec.get(2, 5) == 2.0 * 7.0 - 10.0 + 1.0);
+	ec = elementwiseMax(ec, eb) / 2.0 - ec;
+	assert(ec.get(2, 5) == 10.0 / 2.0 - 5.0);
+	LibMath::Matrix wrongShape(6, 3);
+	wrongShape.zero();
+	wrongShape = ea + eb;
+	assert(wrongShape.get(0, 0) == 0.0);
+	LibMath::Vector ev(5);
+	LibMath::Vector ew(5);
+	for (size_t i = 0; i < 5; ++i)
+	{
+		ev.m_data[i] = (double)i;
+		ew.m_data[i] = -(double)i;
+	}
+	ew = elementwiseProduct(ev, ew) + elementwiseAbs(ew) * 3.0 - ev;
+	assert(ew.m_data[4] == -16.0 + 12.0 - 4.0);
+
+	// Threaded products split C into tiles and A x v into row blocks; they must agree with the single threaded ones.
+	LibMath::SquareMatrix threaded(250);
+	LibMath::SquareMatrix serial(250);
+	LibMath::SquareMatrix factor(250);
+	LibMath::Vector v(250);
+	LibMath::Vector av(250);
+	for (size_t i = 0; i < 250; ++i)
+	{
+		v.m_data[i] = rng.nextDouble();
+		for (size_t j = 0; j < 250; ++j)
+			factor.set(i, j, rng.nextDouble() - 0.5);
+	}
+	LibMath::Parallel::setNumThreads(1);
+	factor.multiply(&factor, &serial);
+	LibMath::Parallel::setNumThreads(3);
+	factor.multiply(&factor, &threaded);
+	factor.multiply(&v, &av);
+	LibMath::Parallel::setNumThreads(0);
+	for (size_t i = 0; i < 250; ++i)
+	{
+		double expected = 0.0;
+		for (size_t j = 0; j < 250; ++j)
+		{
+			assert(threaded.get(i, j) == serial.get(i, j));
+			expected += factor.get(i, j) * v.m_data[j];
+		}
+		assert(fabs(av.m_data[i] - expected) < 1e-12);
+	}
+
+	// The 250 x 250 product above is too small to split; this one splits A x v by rows and A^T x v by columns.
+	const size_t gemvSize = 800;
+	LibMath::SquareMatrix gemvMatrix(gemvSize);
+	LibMath::Vector gemvV(gemvSize);
+	LibMath::Vector serialAv(gemvSize);
+	LibMath::Vector serialAtv(gemvSize);
+	LibMath::Vector threadedAv(gemvSize);
+	LibMath::Vector threadedAtv(gemvSize);
+	for (size_t i = 0; i < gemvSize; ++i)
+	{
+		gemvV.m_data[i] = rng.nextDouble();
+		for (size_t j = 0; j < gemvSize; ++j)
+			gemvMatrix.set(i, j, rng.nextDouble() - 0.5);
+	}
+	LibMath::Parallel::setNumThreads(1);
+	gemvMatrix.multiply(&gemvV, &serialAv);
+	LibMath::multiply(gemvMatrix.view().transpose(), &gemvV, &serialAtv);
+	LibMath::Parallel::setNumThreads(3);
+	gemvMatrix.multiply(&gemvV, &threadedAv);
+	LibMath::multiply(gemvMatrix.view().transpose(), &gemvV, &threadedAtv);
+	LibMath::Parallel::setNumThreads(0);
+	for (size_t i = 0; i < gemvSize; ++i)
+	{
+		assert(fabs(threadedAv.m_data[i] - serialAv.m_data[i]) < 1e-12);
+		assert(fabs(threadedAtv.m_data[i] - serialAtv.m_data[i]) < 1e-12);
+	}
+}
+
+void matrixViewTests()
+{
+	std::cout << "Matrix View Tests:" << std::endl;
+	std::cout << "------------------" << std::endl;
+
+	// M(i, j) = 10i + j, so every element says where it came from.
+	LibMath::Matrix M(6, 5);
+	for (size_t i = 0; i < 6; ++i)
+		for (size_t j = 0; j < 5; ++j)
+			M.set(i, j, 10.0 * i + j);
+	LibMath::MatrixView view = M.view();
+	LibMath::MatrixView block = view.block(1, 2, 3, 2);
+	LibMath::MatrixView transposed = view.transpose();
+	assert(block.width() == 3 && block.height() == 2 && block.get(2, 1) == 33.0);
+	assert(transposed.width() == 5 && transposed.height() == 6 && transposed.get(4, 1) == 14.0);
+	assert(transposed.block(1, 2, 2, 3).transpose().get(2, 1) == 42.0);
+	(void)transposed;
+	assert(view.row(3).get(0, 4) == 34.0 && view.column(4).get(3, 0) == 34.0);
+
+	// Writes go through to the matrix.
+	block.set(0, 0, -1.0);
+	assert(M.get(1, 2) == -1.0);
+	M.set(1, 2, 12.0);
+
+	// Products of blocks and transposes against the same products of copies.
+	LibMath::Matrix product(3, 3);
+	LibMath::multiply(view.block(0, 0, 3, 5), view.block(3, 0, 3, 5).transpose(), &product);
+	for (size_t i = 0; i < 3; ++i)
+	{
+		for (size_t j = 0; j < 3; ++j)
+		{
+			double expected = 0.0;
+			for (size_t k = 0; k < 5; ++k)
+				expected += M.get(i, k) * M.get(3 + j, k);
+			assert(fabs(product.get(i, j) - expected) < 1e-12);
+		}
+	}
+
+	// In place: subtract a row from every other row, and a Schur complement style update of a block.
+	LibMath::Matrix original = M;
+	for (size_t i = 1; i < 6; ++i)
+		LibMath::subtract(view.row(i), view.row(0), view.row(i));
+	for (size_t i = 1; i < 6; ++i)
+		for (size_t j = 0; j < 5; ++j)
+			assert(M.get(i, j) == 10.0 * i);
+	M = original;
+	LibMath::multiply(view.block(2, 0, 4, 2), view.block(0, 2, 2, 3), view.block(2, 2, 4, 3), -1.0, 1.0);
+	for (size_t i = 2; i < 6; ++i)
+		for (size_t j = 2; j < 5; ++j)
+			assert(fabs(M.get(i, j) - (original.get(i, j) - original.get(i, 0) * original.get(0, j) - original.get(i, 1) * original.get(1, j))) < 1e-12);
+
+	// Dots of rows and columns, and views of vectors and external buffers.
+	M = original;
+	assert(LibMath::dot(view.row(1), view.column(1).block(0, 0, 5, 1).transpose()) == 10.0 * 1 + 11.0 * 11 + 12.0 * 21 + 13.0 * 31 + 14.0 * 41);
+	LibMath::Vector ones(5);
+	LibMath::Vector sums(6);
+	std::fill(ones.m_data, ones.m_data + 5, 1.0);
+	LibMath::multiply(&M, &ones, &sums);
+	assert(sums.m_data[2] == 20.0 + 21.0 + 22.0 + 23.0 + 24.0);
+	double buffer[6] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+	LibMath::MatrixView external(buffer, 2, 3, 3);
+	LibMath::Matrix copied(3, 2);
+	LibMath::copy(external.transpose(), &copied);
+	assert(copied.get(2, 0) == 3.0 && copied.get(0, 1) == 4.0);
+}
+
+void decompositionTests()
+{
+	std::cout << "Decomposition Tests:" << std::endl;
+	std::cout << "--------------------" << std::endl;
+
+	// Large enough for several blocks, so the GEMM updates are exercised.
+	const size_t n = 150;
+	LibMath::Random rng(7);
+	LibMath::SquareMatrix A(n);
+	LibMath::SquareMatrix spd(n);
+	for (size_t i = 0; i < n; ++i)
+		for (size_t j = 0; j < n; ++j)
+			A.set(i, j, rng.nextDouble() - 0.5);
+	for (size_t i = 0; i < n; ++i)
+	{
+		for (size_t j = 0; j < n; ++j)
+		{
+			double sum = (i == j) ? 1.0 : 0.0;
+			for (size_t k = 0; k < n; ++k)
+				sum += A.get(i, k) * A.get(j, k);
+			spd.set(i, j, sum);
+		}
+	}
+	LibMath::Matrix B(n, 3);
+	LibMath::Matrix X(n, 3);
+	for (size_t i = 0; i < n; ++i)
+		for (size_t j = 0; j < 3; ++j)
+			B.set(i, j, rng.nextDouble());
+
+	auto maxResidual = [&](const LibMath::Matrix& M) {
+		LibMath::Matrix MX = M * X;
+		double worst = 0.0;
+		for (size_t i = 0; i < n; ++i)
+			for (size_t j = 0; j < 3; ++j)
+				worst = std::max(worst, fabs(MX.get(i, j) - B.get(i, j)));
+		return worst;
+	};
+
+	LibMath::LUDecomposition lu;
+	bool solved = lu.factor(&A) && lu.solve(&B, &X);
+	assert(solved);
+	assert(maxResidual(A) < 1e-10);
+	LibMath::QRDecomposition qr;
+	solved = qr.factor(&A) && qr.solve(&B, &X);
+	assert(solved);
+	assert(maxResidual(A) < 1e-10);
+	assert(fabs(qr.determinant() - lu.determinant()) < 1e-9 * fabs(lu.determinant()));
+	LibMath::CholeskyDecomposition cholesky;
+	solved = cholesky.factor(&spd) && cholesky.solve(&B, &X);
+	assert(solved);
+	assert(maxResidual(spd) < 1e-10);
+	(void)maxResidual;
+	bool factored = cholesky.factor(&A);
+	assert(!factored);
+	(void)factored;
+
+	LibMath::SquareMatrix inverse(n);
+	bool inverted = A.inverse(&inverse);
+	assert(inverted);
+	LibMath::SquareMatrix identity = A * inverse;
+	for (size_t i = 0; i < n; ++i)
+		for (size_t j = 0; j < n; ++j)
+			assert(fabs(identity.get(i, j) - ((i == j) ? 1.0 : 0.0)) < 1e-10);
+
+	// Small cases with known answers.
+	LibMath::SquareMatrix small(3);
+	small.set(0, 0, 0.0); small.set(0, 1, 2.0); small.set(0, 2, 1.0);
+	small.set(1, 0, 1.0); small.set(1, 1, 1.0); small.set(1, 2, 0.0);
+	small.set(2, 0, 3.0); small.set(2, 1, 0.0); small.set(2, 2, 1.0);
+	assert(fabs(small.determinant() + 5.0) < 1e-14);
+	LibMath::Vector b(3);
+	LibMath::Vector x(3);
+	b.m_data[0] = 3.0; b.m_data[1] = 2.0; b.m_data[2] = 4.0;
+	solved = small.solve(&b, &x);
+	assert(solved);
+	assert(fabs(x.m_data[0] - 1.0) < 1e-15 && fabs(x.m_data[1] - 1.0) < 1e-15 && fabs(x.m_data[2] - 1.0) < 1e-15);
+	LibMath::SquareMatrix ones(3);
+	ones.ones();
+	inverted = ones.inverse(&small);
+	assert(ones.determinant() == 0.0 && !inverted);
+	(void)inverted;
+
+	// Least squares: fit y = 2x + 1 through noiseless points.
+	LibMath::Matrix design(5, 2);
+	LibMath::Vector y(5);
+	LibMath::Vector coefficients(2);
+	for (size_t i = 0; i < 5; ++i)
+	{
+		design.set(i, 0, (double)i);
+		design.set(i, 1, 1.0);
+		y.m_data[i] = 2.0 * i + 1.0;
+	}
+	LibMath::QRDecomposition fit;
+	solved = fit.factor(&design) && fit.solve(&y, &coefficients);
+	assert(solved);
+	(void)solved;
+	assert(fabs(coefficients.m_data[0] - 2.0) < 1e-14 && fabs(coefficients.m_data[1] - 1.0) < 1e-14);
+}
+
+void fixedMatrixTests()
+{
+	std::cout << "Fixed Size Matrix Tests:" << std::endl;
+	std::cout << "------------------------" << std::endl;
+
+	// Everything but length and normalization can be evaluated at compile time.
+	constexpr LibMath::Vector3 z = LibMath::Vector3(1.0, 0.0, 0.0).cross(LibMath::Vector3(0.0, 1.0, 0.0));
+	static_assert(z == LibMath::Vector3(0.0, 0.0, 1.0), "x cross y should be z");
+	constexpr LibMath::Matrix3 rotation(0.0, -1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0);
+	static_assert(rotation.determinant() == 1.0, "rotations have a determinant of one");
+	static_assert(rotation * rotation.transpose() == LibMath::Matrix3::identity(), "rotations are orthogonal");
+	static_assert(rotation * LibMath::Vector3(1.0, 2.0, 3.0) == LibMath::Vector3(-2.0, 1.0, 3.0), "90 degrees about z");
+
+	LibMath::Vector3 v(3.0, 4.0, 0.0);
+	assert(v.length() == 5.0);
+	v.normalize();
+	assert((v - LibMath::Vector3(0.6, 0.8, 0.0)).length() < 1e-15);
+	assert(fabs(v.dot(LibMath::Vector3(1.0, 1.0, 1.0)) - 1.4) < 1e-15);
+
+	LibMath::Matrix4 m(2.0, 1.0, 0.0, 0.0,
+		0.0, 4.0, 0.0, 1.0,
+		1.0, 0.0, 8.0, 0.0,
+		0.0, 3.0, 0.0, 1.0);
+	LibMath::Matrix4 inverse;
+	bool inverted = m.inverse(&inverse);
+	assert(inverted);
+	LibMath::Matrix4 shouldBeIdentity = m * inverse;
+	for (size_t i = 0; i < 4; ++i)
+		for (size_t j = 0; j < 4; ++j)
+			assert(fabs(shouldBeIdentity(i, j) - ((i == j) ? 1.0 : 0.0)) < 1e-12);
+	(void)shouldBeIdentity;
+	LibMath::Matrix3 singular(1.0, 2.0, 3.0, 2.0, 4.0, 6.0, 0.0, 1.0, 1.0);
+	LibMath::Matrix3 unused;
+	inverted = singular.inverse(&unused);
+	assert(!inverted);
+	(void)inverted;
+
+	// Conversions to and from the dynamic classes.
+	LibMath::SquareMatrix dynamic(3);
+	dynamic.identity();
+	LibMath::Matrix3 fixed = LibMath::Matrix3::fromMatrix(&dynamic) * 2.0;
+	(fixed * rotation).toMatrix(&dynamic);
+	assert(dynamic.get(1, 0) == 2.0 && dynamic.get(0, 1) == -2.0);
+	LibMath::Vector dynamicVector(3);
+	v.toVector(&dynamicVector);
+	assert(LibMath::Vector3::fromVector(&dynamicVector) == v);
+}
+
+void sparseMatrixTests()
+{
+	std::cout << "Sparse Matrix Tests:" << std::endl;
+	std::cout << "--------------------" << std::endl;
+
+	// Random triplets, with duplicates, against the same matrix built densely.
+	const size_t w = 40;
+	const size_t h = 30;
+	LibMath::Random rng(5);
+	std::vector<size_t> rows;
+	std::vector<size_t> cols;
+	std::vector<double> values;
+	LibMath::Matrix dense(w, h);
+	dense.zero();
+	for (size_t k = 0; k < 300; ++k)
+	{
+		rows.push_back(rng.nextIndex(w));
+		cols.push_back(rng.nextIndex(h));
+		values.push_back(rng.nextDouble() - 0.5);
+		dense.set(rows[k], cols[k], dense.get(rows[k], cols[k]) + values[k]);
+	}
+	LibMath::SparseMatrix csr(w, h, rows.data(), cols.data(), values.data(), values.size());
+	LibMath::SparseMatrix csc(w, h, rows.data(), cols.data(), values.data(), values.size(), LibMath::SparseMatrix::CSC);
+	LibMath::SparseMatrix converted = csr.converted(LibMath::SparseMatrix::CSC);
+	LibMath::SparseMatrix transposed = csc.transpose();
+	assert(csr.nonZeros() == csc.nonZeros() && csr.nonZeros() < values.size());
+	assert(converted.format() == LibMath::SparseMatrix::CSC && transposed.format() == LibMath::SparseMatrix::CSC);
+	for (size_t i = 0; i < w; ++i)
 	{
-		m->identity();
-		std::cout << "Identity matrix:" << std::endl;
-		m->print();
-		delete m;
+		for (size_t j = 0; j < h; ++j)
+		{
+			assert(fabs(csr.get(i, j) - dense.get(i, j)) < 1e-15);
+			assert(csc.get(i, j) == csr.get(i, j) && converted.get(i, j) == csr.get(i, j));
+			assert(transposed.get(j, i) == csr.get(i, j));
+		}
+	}
+
+	LibMath::Vector x(h);
+	LibMath::Matrix X(h, 5);
+	for (size_t j = 0; j < h; ++j)
+	{
+		x.m_data[j] = rng.nextDouble();
+		for (size_t c = 0; c < 5; ++c)
+			X.set(j, c, rng.nextDouble());
+	}
+	LibMath::Vector expected = dense * x;
+	LibMath::Matrix expectedProduct = dense * X;
+	LibMath::SparseMatrix* formats[] = { &csr, &csc };
+	for (LibMath::SparseMatrix* A : formats)
+	{
+		LibMath::Vector y(w);
+		LibMath::Matrix Y(w, 5);
+		A->multiply(&x, &y);
+		A->multiply(&X, &Y);
+		for (size_t i = 0; i < w; ++i)
+		{
+			assert(fabs(y.m_data[i] - expected.m_data[i]) < 1e-13);
+			for (size_t c = 0; c < 5; ++c)
+				assert(fabs(Y.get(i, c) - expectedProduct.get(i, c)) < 1e-13);
+		}
+	}
+
+	// The 2D Poisson stencil on a grid; symmetric for CG, and skewed along one axis for BiCGSTAB.
+	auto poisson = [&](size_t grid, double skew) {
+		rows.clear();
+		cols.clear();
+		values.clear();
+		for (size_t a = 0; a < grid; ++a)
+		{
+			for (size_t b = 0; b < grid; ++b)
+			{
+				size_t i = a * grid + b;
+				rows.push_back(i); cols.push_back(i); values.push_back(4.0);
+				if (a > 0) { rows.push_back(i); cols.push_back(i - grid); values.push_back(-1.0); }
+				if (a + 1 < grid) { rows.push_back(i); cols.push_back(i + grid); values.push_back(-1.0); }
+				if (b > 0) { rows.push_back(i); cols.push_back(i - 1); values.push_back(-1.0 - skew); }
+				if (b + 1 < grid) { rows.push_back(i); cols.push_back(i + 1); values.push_back(-1.0 + skew); }
+			}
+		}
+		return LibMath::SparseMatrix(grid * grid, grid * grid, rows.data(), cols.data(), values.data(), values.size());
+	};
+	const size_t n = 30 * 30;
+	for (double skew = 0.0; skew <= 0.3; skew += 0.3)
+	{
+		LibMath::SparseMatrix A = poisson(30, skew);
+		LibMath::Vector rhs(n);
+		LibMath::Vector solution(n);
+		LibMath::Vector check(n);
+		for (size_t i = 0; i < n; ++i)
+			rhs.m_data[i] = rng.nextDouble();
+		std::fill(solution.m_data, solution.m_data + n, 0.0);
+
+		size_t iterations = 0;
+		bool converged = (skew == 0.0) ?
+			LibMath::IterativeSolvers::conjugateGradient(&A, &rhs, &solution, 1e-10, 1000, true, &iterations) :
+			LibMath::IterativeSolvers::biCGSTAB(&A, &rhs, &solution, 1e-10, 1000, true, &iterations);
+		assert(converged);
+		(void)converged;
+		assert(iterations > 0 && iterations < 1000);
+		A.multiply(&solution, &check);
+		for (size_t i = 0; i < n; ++i)
+			assert(fabs(check.m_data[i] - rhs.m_data[i]) < 1e-8);
+	}
+}
+
+void smallMatrixBatchTests()
+{
+	std::cout << "Small Matrix Batch Tests:" << std::endl;
+	std::cout << "-------------------------" << std::endl;
+
+	// A partial last block, and one singular item, against the same operations one item at a time.
+	typedef LibMath::SmallMatrixBatch Batch;
+	const size_t count = 21;
+	LibMath::Random rng(9);
+	std::vector<double> A(Batch::size(4, count));
+	std::vector<double> B(A.size());
+	std::vector<double> C(A.size());
+	std::vector<double> x(Batch::vectorSize(4, count));
+	std::vector<double> y(x.size());
+	std::vector<double> det(count);
+	for (size_t k = 0; k < A.size(); ++k)
+	{
+		A[k] = rng.nextDouble() - 0.5;
+		B[k] = rng.nextDouble() - 0.5;
+	}
+	for (size_t k = 0; k < x.size(); ++k)
+		x[k] = rng.nextDouble() - 0.5;
+	Batch::store(LibMath::Matrix4(1.0, 2.0, 3.0, 4.0, 2.0, 4.0, 6.0, 8.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 0.0, 1.0), A.data(), 5);
+
+	Batch::multiply(4, count, A.data(), B.data(), C.data());
+	Batch::determinant(4, count, A.data(), det.data());
+	for (size_t item = 0; item < count; ++item)
+	{
+		LibMath::Matrix4 expected = Batch::load<4>(A.data(), item) * Batch::load<4>(B.data(), item);
+		LibMath::Matrix4 product = Batch::load<4>(C.data(), item);
+		for (size_t i = 0; i < 4; ++i)
+			for (size_t j = 0; j < 4; ++j)
+				assert(fabs(product(i, j) - expected(i, j)) < 1e-14);
+		assert(fabs(det[item] - Batch::load<4>(A.data(), item).determinant()) < 1e-14);
+		(void)expected;
+		(void)product;
+	}
+
+	size_t singularInverses = Batch::inverse(4, count, A.data(), C.data());
+	size_t singularSolves = Batch::solve(4, count, A.data(), x.data(), y.data());
+	assert(singularInverses == 1 && singularSolves == 1);
+	(void)singularInverses;
+	(void)singularSolves;
+	for (size_t item = 0; item < count; ++item)
+	{
+		LibMath::Matrix4 a = Batch::load<4>(A.data(), item);
+		LibMath::Matrix4 inverse = Batch::load<4>(C.data(), item);
+		LibMath::Vector4 solution = Batch::loadVector<4>(y.data(), item);
+		if (item == 5)
+		{
+			assert(inverse == LibMath::Matrix4() && solution == LibMath::Vector4());
+			continue;
+		}
+		LibMath::Matrix4 identity = a * inverse;
+		LibMath::Vector4 rhs = a * solution;
+		for (size_t i = 0; i < 4; ++i)
+		{
+			assert(fabs(rhs[i] - x[Batch::vectorIndex(4, item, i)]) < 1e-10);
+			for (size_t j = 0; j < 4; ++j)
+				assert(fabs(identity(i, j) - ((i == j) ? 1.0 : 0.0)) < 1e-10);
+		}
+		(void)identity;
+		(void)rhs;
 	}
 
-	m = new LibMath::SquareMatrix(5);
-	if (m)
+	// Rotating 3-vectors, each by its own matrix.
+	std::vector<double> rotations(Batch::size(3, count));
+	std::vector<double> points(Batch::vectorSize(3, count));
+	std::vector<double> rotated(points.size());
+	for (size_t item = 0; item < count; ++item)
 	{
-		m->zero();
-		std::cout << "Zero matrix:" << std::endl;
-		m->print();
-		m->ones();
-		std::cout << "Ones matrix:" << std::endl;
-		m->print();
-		m->multiply(2.0);
-		std::cout << "Ones matrix multiplied by 2.0:" << std::endl;
-		m->print();
-		delete m;
+		double angle = 0.1 * item;
+		Batch::store(LibMath::Matrix3(cos(angle), -sin(angle), 0.0, sin(angle), cos(angle), 0.0, 0.0, 0.0, 1.0), rotations.data(), item);
+		Batch::store(LibMath::Vector3(1.0, 0.0, 2.0), points.data(), item);
+	}
+	Batch::multiplyVector(3, count, rotations.data(), points.data(), rotated.data());
+	for (size_t item = 0; item < count; ++item)
+	{
+		LibMath::Vector3 p = Batch::loadVector<3>(rotated.data(), item);
+		assert(fabs(p[0] - cos(0.1 * item)) < 1e-15 && fabs(p[1] - sin(0.1 * item)) < 1e-15 && p[2] == 2.0);
+		(void)p;
 	}
 }
 
@@ -214,9 +812,176 @@ void distanceTests()
 	std::cout << "Hamming Distance: " << distance << std::endl;
 	assert(distance == 2);
 
+	// Packed fingerprints, 320 bits each.
+	uint64_t fingerprints[3][5] = {
+		{ 0x0ULL, 0xFFULL, 0x1ULL, 0x0ULL, 0x8000000000000000ULL },
+		{ 0x1ULL, 0x0FULL, 0x1ULL, 0x0ULL, 0x0ULL },
+		{ 0x0ULL, 0xFFULL, 0x1ULL, 0x0ULL, 0x8000000000000000ULL } };
+	uint32_t hammingDistances[3];
+	LibMath::Distance::hammingDistancesFrom(fingerprints[0], &fingerprints[0][0], 3, 5, hammingDistances);
+	std::cout << "Packed Hamming Distances: " << hammingDistances[0] << " " << hammingDistances[1] << " " << hammingDistances[2] << std::endl;
+	assert(hammingDistances[0] == 0 && hammingDistances[1] == 6 && hammingDistances[2] == 0);
+	assert(LibMath::Distance::hammingDistance(fingerprints[1], fingerprints[2], 5) == 6);
+	uint32_t hammingMatrix[6];
+	LibMath::Distance::hammingDistanceMatrix(&fingerprints[1][0], 2, &fingerprints[0][0], 3, 5, hammingMatrix);
+	assert(hammingMatrix[0] == 6 && hammingMatrix[1] == 0 && hammingMatrix[2] == 6 && hammingMatrix[3] == 0 && hammingMatrix[5] == 0);
+
+	double lat[] = { 27.9500, 27.9510, 27.9525, 27.9600 };
+	double lon[] = { -82.4500, -82.4490, -82.4470, -82.4400 };
+	double alt[] = { 10.0, 12.0, 9.0, 15.0 };
+	double distances[3];
+	LibMath::Distance::haversineDistancesConsecutive(lat, lon, alt, 4, distances);
+	for (size_t i = 0; i < 3; ++i)
+	{
+		double expected = LibMath::Distance::haversineDistance(lat[i], lon[i], alt[i], lat[i + 1], lon[i + 1], alt[i + 1]);
+		assert(fabs(distances[i] - expected) <= 1e-12 * expected);
+		(void)expected;
+	}
+	std::cout << "Haversine Distances: " << distances[0] << " " << distances[1] << " " << distances[2] << std::endl;
+
+	// Pairwise Euclidian distances, as a full matrix, as the upper triangle, and as nearest neighbors.
+	double points[] = { 0.0, 0.0, 3.0, 4.0, 6.0, 8.0, 0.0, 1.0 };
+	double pairwise[16];
+	LibMath::Distance::euclidianDistanceMatrix(points, 4, points, 4, 2, pairwise);
+	double condensed[6];
+	LibMath::Distance::euclidianDistancesCondensed(points, 4, 2, condensed);
+	double expectedCondensed[] = { 5.0, 10.0, 1.0, 5.0, sqrt(18.0), sqrt(85.0) };
+	for (size_t i = 0; i < 6; ++i)
+		assert(fabs(condensed[i] - expectedCondensed[i]) < 1e-9);
+	(void)expectedCondensed;
+	assert(fabs(pairwise[1 * 4 + 2] - 5.0) < 1e-9 && fabs(pairwise[3 * 4 + 2] - sqrt(85.0)) < 1e-9);
+	size_t neighbors[8];
+	double neighborDistances[8];
+	LibMath::Distance::euclidianNearestNeighbors(points, 4, 2, 2, neighbors, neighborDistances);
+	std::cout << "Nearest Neighbors of Point 0: " << neighbors[0] << " " << neighbors[1] << std::endl;
+	assert(neighbors[0] == 3 && neighbors[1] == 1);
+	assert(neighbors[2 * 2] == 1 && fabs(neighborDistances[2 * 2] - 5.0) < 1e-9);
+
+	// Zero dimensions and empty point sets leave the outputs alone; a query against no points is all padding.
+	double untouched[] = { -1.0, -1.0 };
+	size_t untouchedIndices[] = { 7, 7 };
+	LibMath::Distance::euclidianDistanceMatrix(points, 1, points, 2, 0, untouched);
+	LibMath::Distance::euclidianDistanceMatrix(points, 0, points, 2, 2, untouched);
+	LibMath::Distance::euclidianDistancesCondensed(points, 2, 0, untouched);
+	LibMath::Distance::euclidianDistancesCondensed(points, 1, 2, untouched);
+	LibMath::Distance::euclidianNearestNeighbors(points, 2, 0, 1, untouchedIndices, untouched);
+	LibMath::Distance::euclidianNearestNeighbors(points, 0, points, 2, 2, 1, untouchedIndices, untouched);
+	assert(untouched[0] == -1.0 && untouched[1] == -1.0 && untouchedIndices[0] == 7 && untouchedIndices[1] == 7);
+	LibMath::Distance::euclidianNearestNeighbors(points, 1, points, 0, 2, 2, untouchedIndices, untouched);
+	assert(untouchedIndices[0] == (size_t)-1 && untouchedIndices[1] == (size_t)-1 && untouched[1] == HUGE_VAL);
+
+	// Dynamic time warping lines up a shifted copy of a series that plain Euclidian distance doesn't.
+	double series1[] = { 0.0, 0.0, 1.0, 2.0, 1.0, 0.0, 0.0, 0.0 };
+	double series2[] = { 0.0, 0.0, 0.0, 1.0, 2.0, 1.0, 0.0, 0.0 };
+	double dtw = LibMath::Distance::dtwDistance(series1, 8, series2, 8, 2);
+	std::cout << "DTW Distance: " << dtw << std::endl;
+	assert(dtw < 1e-12);
+	assert(fabs(LibMath::Distance::dtwDistance(series1, 8, series2, 8, 0) - sqrt(4.0)) < 1e-12);
+	double upper[8], lower[8];
+	LibMath::Distance::dtwEnvelope(series2, 8, 1, upper, lower);
+	assert(upper[2] == 1.0 && lower[2] == 0.0 && upper[4] == 2.0 && lower[4] == 1.0);
+	assert(LibMath::Distance::lbKeogh(series1, upper, lower, 8) <= dtw + 1e-12);
+	assert(LibMath::Distance::lbKim(series1, series2, 8) <= dtw + 1e-12);
+
+	// Find a scaled and offset copy of the query in a longer signal.
+	double signal[64];
+	for (size_t i = 0; i < 64; ++i)
+		signal[i] = sin(0.37 * i * i);
+	double query[12];
+	for (size_t i = 0; i < 12; ++i)
+		query[i] = 3.0 * signal[40 + i] + 1.0;
+	double matchDistance;
+	size_t matchStart = LibMath::Distance::dtwSubsequenceSearch(signal, 64, query, 12, 2, true, &matchDistance);
+	std::cout << "DTW Subsequence Match: " << matchStart << std::endl;
+	assert(matchStart == 40 && matchDistance < 1e-6);
+
 	distance = LibMath::Distance::levenshteinDistance("foo", "foobar");
 	std::cout << "Levenshtein Distance: " << distance << std::endl << std::endl;
 	assert(distance == 3);
+	assert(LibMath::Distance::levenshteinDistance("kitten", "sitting") == 3);
+	assert(LibMath::Distance::levenshteinDistance("abc", "abd") == 1);
+	assert(LibMath::Distance::levenshteinDistance("", "abc") == 3);
+
+	// Long strings take more than one 64 bit word per column.
+	std::string longStr1(150, 'a');
+	std::string longStr2 = longStr1;
+	longStr2[3] = 'b';
+	longStr2.erase(70, 1);
+	longStr2 += "cd";
+	assert(LibMath::Distance::levenshteinDistance(longStr1.c_str(), longStr2.c_str()) == 3);
+	assert(LibMath::Distance::levenshteinWithin(longStr1.c_str(), longStr2.c_str(), 3));
+	assert(!LibMath::Distance::levenshteinWithin(longStr1.c_str(), longStr2.c_str(), 2));
+	assert(LibMath::Distance::levenshteinWithin("kitten", "sitting", 3));
+	assert(!LibMath::Distance::levenshteinWithin("kitten", "sitting", 2));
+	assert(!LibMath::Distance::levenshteinWithin("abc", "abcdef", 2));
+}
+
+void trackTests()
+{
+	std::cout << "Track Tests:" << std::endl;
+	std::cout << "------------" << std::endl;
+
+	double timestamps[] = { 0.0, 10.0, 20.0, 20.0, 35.0, 50.0 };
+	double lat[] = { 27.9500, 27.9509, 27.9518, 27.9518, 27.9530, 27.9530 };
+	double lon[] = { -82.4500, -82.4500, -82.4500, -82.4500, -82.4500, -82.4500 };
+	double cumulative[6], speed[6], pace[6];
+	LibMath::Track::process(timestamps, lat, lon, NULL, 6, 2, cumulative, speed, pace);
+
+	LibMath::LiveTrack live(2);
+	for (size_t i = 0; i < 6; ++i)
+	{
+		live.addPoint(timestamps[i], lat[i], lon[i], 0.0);
+		assert(fabs(live.cumulativeDistance() - cumulative[i]) < 1e-9);
+		assert(fabs(live.speed() - speed[i]) < 1e-9);
+		assert(fabs(live.pace() - pace[i]) < 1e-9);
+		std::cout << "Distance: " << cumulative[i] << " Speed: " << speed[i] << " Pace: " << pace[i] << std::endl;
+	}
+	assert(fabs(cumulative[5] - LibMath::Distance::haversineDistance(lat[0], lon[0], 0.0, lat[5], lon[5], 0.0)) < 1e-6);
+
+	// A track longer than one block, with altitude, against the streaming form.
+	const size_t LONG_TRACK = 1300;
+	std::vector<double> longTimes(LONG_TRACK), longLat(LONG_TRACK), longLon(LONG_TRACK), longAlt(LONG_TRACK);
+	for (size_t i = 0; i < LONG_TRACK; ++i)
+	{
+		longTimes[i] = 2.0 * (double)i;
+		longLat[i] = 27.95 + 0.00005 * (double)i;
+		longLon[i] = -82.45 + 0.00003 * sin(0.01 * (double)i);
+		longAlt[i] = 10.0 * cos(0.02 * (double)i);
+	}
+	std::vector<double> longCumulative(LONG_TRACK), longSpeed(LONG_TRACK), longPace(LONG_TRACK);
+	LibMath::Track::process(longTimes.data(), longLat.data(), longLon.data(), longAlt.data(), LONG_TRACK, 30,
+		longCumulative.data(), longSpeed.data(), longPace.data());
+	LibMath::LiveTrack longLive(30);
+	for (size_t i = 0; i < LONG_TRACK; ++i)
+	{
+		longLive.addPoint(longTimes[i], longLat[i], longLon[i], longAlt[i]);
+		assert(fabs(longLive.cumulativeDistance() - longCumulative[i]) < 1e-6);
+		assert(fabs(longLive.speed() - longSpeed[i]) < 1e-9);
+		assert(fabs(longLive.pace() - longPace[i]) < 1e-9);
+	}
+
+	// Simplify a track that runs straight north, with a 15m jog part way along.
+	double trackLat[] = { 27.9500, 27.9501, 27.9502, 27.9503, 27.9504, 27.9505, 27.9506, 27.9507 };
+	double trackLon[] = { -82.4500, -82.4500, -82.4500, -82.45015, -82.4500, -82.4500, -82.4500, -82.4500 };
+	size_t kept[8];
+	size_t numKept = LibMath::Polyline::douglasPeucker(trackLat, trackLon, 8, 5.0, kept);
+	std::cout << "Douglas-Peucker Kept: " << numKept << std::endl;
+	assert(numKept == 5 && kept[0] == 0 && kept[2] == 3 && kept[4] == 7);
+	numKept = LibMath::Polyline::douglasPeucker(trackLat, trackLon, 8, 20.0, kept);
+	assert(numKept == 2);
+	numKept = LibMath::Polyline::visvalingamWhyatt(trackLat, trackLon, 8, 100.0, kept);
+	assert(numKept == 5 && kept[2] == 3);
+	numKept = LibMath::Polyline::visvalingamWhyatt(trackLat, trackLon, 8, 200.0, kept);
+	assert(numKept == 2);
+
+	LibMath::LivePolyline livePolyline(5.0);
+	for (size_t i = 0; i < 8; ++i)
+		livePolyline.addPoint(trackLat[i], trackLon[i]);
+	livePolyline.finish();
+	const std::vector<size_t>& liveKept = livePolyline.keptIndices();
+	assert(liveKept.size() == 5 && liveKept[2] == 3 && liveKept[4] == 7);
+	(void)liveKept;
+	std::cout << std::endl;
 }
 
 void kmeansTests()
@@ -243,8 +1008,293 @@ void kmeansTests()
 		{
 			std::cout << tags[i] << std::endl;
 		}
-		delete tags;
+		delete[] tags;
+	}
+	std::cout << std::endl;
+
+	tags = LibMath::KMeans::withEquallySpacedCentroids1D(kMeansIn, 10, 1, (double)0.001, 3);
+	assert(tags);
+	for (size_t i = 0; i < 10; ++i)
+		assert(tags[i] == 0);
+	delete[] tags;
+
+	tags = LibMath::KMeans::withKMeansPlusPlusCentroids1D(kMeansIn, 10, 3, (double)0.001, 10, 42);
+	assert(tags);
+	assert(tags[2] == tags[5] && tags[2] == tags[9]);
+	delete[] tags;
+
+	// Three 2D blobs.
+	double kMeansIn2D[30];
+	for (size_t i = 0; i < 15; ++i)
+	{
+		double center = (double)(i % 3) * 10.0;
+		kMeansIn2D[2 * i] = center + 0.1 * (double)(i / 3);
+		kMeansIn2D[2 * i + 1] = -center;
+	}
+	for (size_t pass = 0; pass < 2; ++pass)
+	{
+		if (pass == 0)
+			tags = LibMath::KMeans::withKMeansPlusPlusCentroidsND(kMeansIn2D, 15, 2, 3, (double)0.001, 10, 7);
+		else
+			tags = LibMath::KMeans::withKMeansParallelCentroidsND(kMeansIn2D, 15, 2, 3, (double)0.001, 10, 7);
+		assert(tags);
+		assert(tags[0] != tags[1] && tags[1] != tags[2] && tags[0] != tags[2]);
+		for (size_t i = 3; i < 15; ++i)
+			assert(tags[i] == tags[i % 3]);
+		delete[] tags;
+	}
+	std::cout << "k-means++ and k-means|| seeding found all three clusters." << std::endl;
+
+	// Several short series in one call, compared against clustering each one separately.
+	size_t offsets[4] = { 0, 10, 13, 20 };
+	double batchIn[20];
+	for (size_t i = 0; i < 10; ++i)
+		batchIn[i] = kMeansIn[i];
+	for (size_t i = 10; i < 20; ++i)
+		batchIn[i] = (double)((i * 7) % 5);
+	size_t batchTags[20];
+	bool clustered = LibMath::KMeans::kMeans1DBatch(batchIn, offsets, 3, 3, (double)0.001, 3, batchTags);
+	assert(clustered);
+	(void)clustered;
+	for (size_t series = 0; series < 3; ++series)
+	{
+		tags = LibMath::KMeans::withEquallySpacedCentroids1D(batchIn + offsets[series], offsets[series + 1] - offsets[series], 3, (double)0.001, 3);
+		for (size_t i = offsets[series]; i < offsets[series + 1]; ++i)
+			assert(tags[i - offsets[series]] == batchTags[i]);
+		delete[] tags;
+	}
+
+	// Repeated clustering through a workspace, with the tags written to our own storage.
+	LibMath::KMeansWorkspace workspace;
+	LibMath::Random rng(42);
+	size_t tags2D[15];
+	for (size_t pass = 0; pass < 3; ++pass)
+	{
+		clustered = LibMath::KMeans::withKMeansPlusPlusCentroids(kMeansIn2D, 15, 2, 3, (double)0.001, 10, rng, tags2D, workspace);
+		assert(clustered);
+		for (size_t i = 3; i < 15; ++i)
+			assert(tags2D[i] == tags2D[i % 3]);
+	}
+}
+
+void bkTreeTests()
+{
+	std::cout << "BK-Tree Tests:" << std::endl;
+	std::cout << "--------------" << std::endl;
+
+	const char* words[] = { "book", "books", "cake", "boo", "boon", "cook", "cape", "cart", "book", "" };
+	LibMath::BKTree tree;
+	bool built = tree.build(words, 10);
+	assert(built);
+	(void)built;
+
+	// Use a copy of the flat buffer in place, as if it had been memory mapped.
+	std::vector<uint64_t> buffer((tree.serializedSize() + 7) / 8);
+	bool serialized = tree.serialize(buffer.data(), buffer.size() * 8);
+	assert(serialized);
+	(void)serialized;
+	LibMath::BKTree attached;
+	bool attachedOk = attached.attach(buffer.data(), buffer.size() * 8);
+	assert(attachedOk);
+	(void)attachedOk;
+
+	// Damaged buffers are turned away: the header, then the offsets, a node's child count, and an order entry.
+	LibMath::BKTree rejected;
+	bool rejectedOk = false;
+	for (size_t damage = 0; damage < 3; ++damage)
+	{
+		std::vector<uint64_t> damaged = buffer;
+		uint32_t* damagedNodes = (uint32_t*)(damaged.data() + 4 + 11);
+		uint32_t* damagedOrder = damagedNodes + ((damaged[2] * 5 * 4 + 7) & ~(size_t)7) / 4;
+		if (damage == 0)
+			damaged[4 + 10] = damaged[3] + 1;
+		else if (damage == 1)
+			damagedNodes[3] = 1000;
+		else
+			damagedOrder[9] = 10;
+		rejectedOk = rejectedOk || rejected.attach(damaged.data(), damaged.size() * 8);
+	}
+	assert(!rejectedOk && rejected.size() == 0);
+	(void)rejectedOk;
+
+	for (size_t k = 0; k < 4; ++k)
+	{
+		std::vector<size_t> found;
+		attached.within("book", k, found);
+		std::sort(found.begin(), found.end());
+
+		std::vector<size_t> expected;
+		for (size_t i = 0; i < 10; ++i)
+		{
+			if (LibMath::Distance::levenshteinDistance("book", words[i]) <= k)
+				expected.push_back(i);
+		}
+		std::cout << "Within " << k << " of book: " << found.size() << std::endl;
+		assert(found == expected);
+	}
+
+	const char* queries[] = { "cak", "boko" };
+	std::vector<std::vector<size_t> > results;
+	tree.withinBatch(queries, 2, 1, results);
+	assert(results[0].size() == 1 && results[0][0] == 2);
+	assert(results[1].size() == 1 && results[1][0] == 3);
+
+	// A tree big enough to split the root's distances across threads, and later levels by node, comes out the same
+	// as one built on a single thread.
+	std::vector<std::string> manyWords(6000);
+	std::vector<const char*> manyPointers(manyWords.size());
+	for (size_t i = 0; i < manyWords.size(); ++i)
+	{
+		for (size_t len = 3 + (i * 7) % 6, j = 0; j < len; ++j)
+			manyWords[i].push_back((char)('a' + (i * 31 + j * 17 + (i >> j)) % 6));
+		manyPointers[i] = manyWords[i].c_str();
+	}
+	std::vector<uint64_t> serialBuffer;
+	for (size_t numThreads = 1; numThreads <= 4; numThreads += 3)
+	{
+		LibMath::Parallel::setNumThreads(numThreads);
+		LibMath::BKTree manyTree;
+		built = manyTree.build(manyPointers.data(), manyPointers.size());
+		assert(built);
+		std::vector<uint64_t> manyBuffer((manyTree.serializedSize() + 7) / 8);
+		serialized = manyTree.serialize(manyBuffer.data(), manyBuffer.size() * 8);
+		assert(serialized);
+		if (numThreads == 1)
+			serialBuffer = manyBuffer;
+		assert(manyBuffer == serialBuffer);
+	}
+	LibMath::Parallel::setNumThreads(0);
+	std::cout << std::endl;
+}
+
+void streamingKMeansTests()
+{
+	std::cout << "Streaming K-Means Tests:" << std::endl;
+	std::cout << "------------------------" << std::endl;
+
+	// Two well separated 2D clusters, interleaved so that every batch sees both.
+	double points[40];
+	for (size_t i = 0; i < 20; ++i)
+	{
+		double offset = (i % 2 == 0) ? 0.0 : 10.0;
+		points[2 * i] = offset + 0.01 * (double)i;
+		points[2 * i + 1] = offset - 0.01 * (double)i;
+	}
+
+	LibMath::MiniBatchKMeans miniBatch(2, 2);
+	for (size_t batch = 0; batch < 4; ++batch)
+	{
+		miniBatch.addBatch(points + batch * 10, 5);
+	}
+	size_t tags[20];
+	miniBatch.label(points, 20, tags);
+	for (size_t i = 2; i < 20; ++i)
+	{
+		assert(tags[i] == tags[i % 2]);
 	}
+	assert(tags[0] != tags[1]);
+	std::cout << "Mini-batch centroids: {" << miniBatch.centroids()[0] << ", " << miniBatch.centroids()[1] << "} {" << miniBatch.centroids()[2] << ", " << miniBatch.centroids()[3] << "}" << std::endl;
+
+	LibMath::StreamingKMeans streaming(2, 2, 0.05);
+	streaming.addBatch(points, 20);
+	assert(streaming.isInitialized());
+	assert(streaming.label(points) != streaming.label(points + 2));
+	std::cout << "Streaming centroids: {" << streaming.centroids()[0] << ", " << streaming.centroids()[1] << "} {" << streaming.centroids()[2] << ", " << streaming.centroids()[3] << "}" << std::endl;
+	std::cout << std::endl;
+}
+
+void dbscanTests()
+{
+	std::cout << "DBSCAN Tests:" << std::endl;
+	std::cout << "-------------" << std::endl;
+
+	// Two stops about a kilometer apart, and one stray fix.
+	double lat[] = { 27.9500, 27.95001, 27.95002, 27.95001, 27.9600, 27.96001, 27.96002, 27.9700 };
+	double lon[] = { -82.4500, -82.45001, -82.45002, -82.45000, -82.4500, -82.45001, -82.45002, -82.4000 };
+	size_t tags[8];
+	size_t numClusters = LibMath::DBSCAN::dbscanHaversine(lat, lon, 8, 10.0, 3, tags);
+	std::cout << "Found " << numClusters << " clusters." << std::endl;
+	assert(numClusters == 2);
+	assert(tags[0] == 0 && tags[1] == 0 && tags[2] == 0 && tags[3] == 0);
+	assert(tags[4] == 1 && tags[5] == 1 && tags[6] == 1);
+	assert(tags[7] == LibMath::DBSCAN::NOISE);
+	std::cout << std::endl;
+}
+
+void geoIndexTests()
+{
+	std::cout << "Geo Index Tests:" << std::endl;
+	std::cout << "----------------" << std::endl;
+
+	// Random points around the antimeridian and the north pole, checked against brute force.
+	const size_t NUM_POINTS = 2000;
+	std::vector<double> lat(NUM_POINTS), lon(NUM_POINTS);
+	LibMath::Random rng(7);
+	for (size_t i = 0; i < NUM_POINTS; ++i)
+	{
+		lat[i] = 60.0 + 30.0 * rng.nextDouble();
+		lon[i] = 170.0 + 20.0 * rng.nextDouble();
+		if (lon[i] > 180.0)
+			lon[i] -= 360.0;
+	}
+	LibMath::GeoIndex index;
+	bool built = index.build(lat.data(), lon.data(), NUM_POINTS);
+	assert(built);
+	(void)built;
+	assert(index.size() == NUM_POINTS);
+
+	// Use a copy of the flat buffer in place, as if it had been memory mapped.
+	std::vector<uint64_t> buffer((index.serializedSize() + 7) / 8);
+	bool serialized = index.serialize(buffer.data(), buffer.size() * 8);
+	assert(serialized);
+	(void)serialized;
+	LibMath::GeoIndex attached;
+	bool attachedOk = attached.attach(buffer.data(), buffer.size() * 8);
+	assert(attachedOk);
+	(void)attachedOk;
+	assert(attached.size() == NUM_POINTS);
+
+	// Damaged buffers are turned away: a different leaf size, and a split axis past z (the axes are the last bytes).
+	std::vector<uint64_t> damaged = buffer;
+	LibMath::GeoIndex rejected;
+	damaged[2] = 1;
+	bool rejectedOk = rejected.attach(damaged.data(), damaged.size() * 8);
+	damaged = buffer;
+	((uint8_t*)damaged.data())[damaged.size() * 8 - ((NUM_POINTS + 7) & ~(size_t)7) + NUM_POINTS / 2] = 3;
+	rejectedOk = rejectedOk || rejected.attach(damaged.data(), damaged.size() * 8);
+	assert(!rejectedOk && rejected.size() == 0);
+	(void)rejectedOk;
+
+	for (size_t query = 0; query < 20; ++query)
+	{
+		double qLat = lat[query] + 0.01;
+		double qLon = lon[query];
+		std::vector<double> bruteForce(NUM_POINTS);
+		for (size_t i = 0; i < NUM_POINTS; ++i)
+			bruteForce[i] = LibMath::Distance::haversineDistance(qLat, qLon, 0.0, lat[i], lon[i], 0.0);
+		std::vector<double> sorted = bruteForce;
+		std::sort(sorted.begin(), sorted.end());
+
+		size_t indices[5];
+		double distances[5];
+		size_t numNearest = attached.nearest(qLat, qLon, 5, indices, distances);
+		assert(numNearest == 5);
+		(void)numNearest;
+		for (size_t i = 0; i < 5; ++i)
+		{
+			assert(fabs(distances[i] - sorted[i]) < 1e-3);
+			assert(fabs(bruteForce[indices[i]] - distances[i]) < 1e-3);
+		}
+
+		std::vector<size_t> found;
+		double radius = 0.5 * (sorted[9] + sorted[10]);
+		size_t numFound = index.withinRadius(qLat, qLon, radius, found);
+		assert(numFound == 10);
+		(void)numFound;
+		for (size_t i = 0; i < found.size(); ++i)
+			assert(bruteForce[found[i]] <= radius);
+	}
+	std::cout << "Nearest neighbor and radius queries match brute force." << std::endl;
 	std::cout << std::endl;
 }
 
@@ -372,6 +1422,16 @@ int main(int argc, const char * argv[])
 	std::cout << std::endl;
 	squareMatrixTests();
 	std::cout << std::endl;
+	matrixViewTests();
+	std::cout << std::endl;
+	fixedMatrixTests();
+	std::cout << std::endl;
+	smallMatrixBatchTests();
+	std::cout << std::endl;
+	decompositionTests();
+	std::cout << std::endl;
+	sparseMatrixTests();
+	std::cout << std::endl;
 	statisticsTests();
 	std::cout << std::endl;
 	signalsTests();
@@ -380,8 +1440,18 @@ int main(int argc, const char * argv[])
 	std::cout << std::endl;
 	distanceTests();
 	std::cout << std::endl;
+	bkTreeTests();
+	std::cout << std::endl;
+	trackTests();
+	std::cout << std::endl;
 	kmeansTests();
 	std::cout << std::endl;
+	streamingKMeansTests();
+	std::cout << std::endl;
+	dbscanTests();
+	std::cout << std::endl;
+	geoIndexTests();
+	std::cout << std::endl;
 
 	if (csvFileName.length() > 0)
 	{